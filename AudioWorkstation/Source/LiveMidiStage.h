@@ -0,0 +1,392 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+
+// Live MIDI processing ahead of the synth: scale quantise, chord memory and an
+// arpeggiator, run on the audio thread inside processBlock so a keyboard can
+// drive patterns with no extra plugin (or extra block of latency) in between.
+//
+// Incoming keys are quantised to the sequencer's key and mode, expanded by the
+// chord memory shape, and either played straight through or collected in the
+// held-note set the arpeggiator reads. Arpeggiator steps sit on the host's PPQ
+// grid while the transport runs (a free-running clock at the host or default
+// tempo otherwise), and each step and gate end is placed on its exact sample.
+// Input events and arpeggiator events are merged in time order, so a chord
+// pressed on a step is heard on that step.
+//
+// Everything is fixed capacity: no allocation happens after prepare().
+class LiveMidiStage
+{
+public:
+    enum class ArpMode
+    {
+        off = 0,
+        up,
+        down,
+        upDown,
+        asPlayed,
+        random,
+        chord
+    };
+
+    static constexpr int maxHeldNotes = 32;    // After chord expansion
+    static constexpr int maxChordIntervals = 8;
+
+    struct Settings
+    {
+        ArpMode arpMode = ArpMode::off;
+        double arpRate = 0.25;   // Step length in quarter notes
+        int arpOctaves = 1;
+        float arpGate = 0.5f;    // Fraction of a step each arpeggiated note lasts
+        bool chordMemory = false;
+        bool scaleQuantise = false;
+    };
+
+    struct Timing
+    {
+        double bpm = 120.0;
+        bool hostPlaying = false; // With a PPQ position
+        double ppq = 0.0;
+    };
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        output.ensureSize(8192);
+        reset();
+    }
+
+    // Forgets held notes without sending note-offs (the synth is being reset too)
+    void reset()
+    {
+        numHeld = 0;
+        numSorted = 0;
+        numArpNotes = 0;
+        arpIndex = 0;
+        lastStepPpq = -1.0;
+        freePpq = 0.0;
+        heldShape.store(0);
+    }
+
+    // Scale for quantising: bit n set when the pitch class root + n is in the scale
+    void setScale(int rootPitchClass, juce::uint16 pitchClassMask)
+    {
+        scale.store(((juce::uint32) (rootPitchClass % 12) << 16) | pitchClassMask);
+    }
+
+    // Chord memory shape: bit n set for an interval of n semitones above the key
+    void setChordShape(juce::uint32 intervalMask) { chordShape.store(intervalMask | 1u); }
+    juce::uint32 getChordShape() const { return chordShape.load(); }
+
+    // Interval mask of the keys currently held, for learning a chord shape
+    juce::uint32 getHeldShape() const { return heldShape.load(); }
+
+    void process(juce::MidiBuffer& midi, int numSamples, const Settings& settings, const Timing& timing)
+    {
+        output.clear();
+
+        // Mode changes release whatever was sounding the old way
+        if (settings.arpMode != lastMode || settings.chordMemory != lastChordMemory || settings.scaleQuantise != lastQuantise)
+        {
+            releaseAll(0);
+            numHeld = 0;
+            numSorted = 0;
+            lastMode = settings.arpMode;
+            lastChordMemory = settings.chordMemory;
+            lastQuantise = settings.scaleQuantise;
+        }
+
+        auto arpeggiating = settings.arpMode != ArpMode::off;
+        auto rate = juce::jmax(1.0 / 64.0, settings.arpRate);
+        auto ppqPerSample = juce::jmax(1.0, timing.bpm) / (60.0 * sampleRate);
+        auto blockStartPpq = timing.hostPlaying ? timing.ppq : freePpq;
+
+        // A jump back (a loop, or a relocate) restarts the step grid
+        if (blockStartPpq < lastStepPpq - rate)
+            lastStepPpq = -1.0;
+
+        auto sampleForPpq = [&](double ppq) { return (int) std::ceil((ppq - blockStartPpq) / ppqPerSample - 1.0e-6); };
+
+        auto nextStepPpq = std::ceil(blockStartPpq / rate - 1.0e-9) * rate;
+        if (nextStepPpq <= lastStepPpq + 1.0e-9)
+            nextStepPpq = lastStepPpq + rate;
+
+        auto inputs = midi.cbegin();
+        const auto inputsEnd = midi.cend();
+
+        for (;;)
+        {
+            auto nextInput = inputs != inputsEnd ? (*inputs).samplePosition : numSamples;
+            auto nextStep = arpeggiating ? juce::jmax(0, sampleForPpq(nextStepPpq)) : numSamples;
+            auto nextGateEnd = arpeggiating && numArpNotes > 0 ? juce::jmax(0, sampleForPpq(arpOffPpq)) : numSamples;
+
+            auto next = juce::jmin(nextInput, nextStep, nextGateEnd);
+            if (next >= numSamples)
+                break;
+
+            // At the same sample: note-offs first, then input, then the new step
+            if (nextGateEnd == next)
+            {
+                stopArpNotes(next);
+            }
+            else if (nextInput == next)
+            {
+                handleInput((*inputs).getMessage(), next, settings);
+                ++inputs;
+            }
+            else
+            {
+                playArpStep(next, settings);
+                lastStepPpq = nextStepPpq;
+                arpOffPpq = nextStepPpq + rate * juce::jlimit(0.05, 1.0, (double) settings.arpGate);
+                nextStepPpq += rate;
+            }
+        }
+
+        freePpq = blockStartPpq + numSamples * ppqPerSample;
+
+        // Copied back rather than swapped, so the preallocated buffer stays ours
+        midi.clear();
+        midi.addEvents(output, 0, numSamples, 0);
+    }
+
+private:
+    struct HeldNote
+    {
+        int note = 0;
+        int key = 0;      // The key that produced it, for its note-off
+        int channel = 1;
+        float velocity = 0.0f;
+    };
+
+    double sampleRate = 44100.0;
+    juce::MidiBuffer output;
+
+    // Held notes in press order, and sorted (duplicates removed) for the arpeggiator
+    std::array<HeldNote, maxHeldNotes> held {};
+    std::array<HeldNote, maxHeldNotes> sorted {};
+    int numHeld = 0, numSorted = 0;
+
+    // Sounding arpeggiator notes
+    std::array<HeldNote, maxHeldNotes> arpNotes {};
+    int numArpNotes = 0;
+    int arpIndex = 0;
+    double lastStepPpq = -1.0, arpOffPpq = 0.0, freePpq = 0.0;
+    juce::Random random;
+
+    ArpMode lastMode = ArpMode::off;
+    bool lastChordMemory = false, lastQuantise = false;
+
+    std::atomic<juce::uint32> scale { 0xAB5 };          // C major
+    std::atomic<juce::uint32> chordShape { 0x91 };      // Major triad: 0, 4, 7
+    std::atomic<juce::uint32> heldShape { 0 };
+
+    void handleInput(const juce::MidiMessage& message, int sample, const Settings& settings)
+    {
+        if (! (message.isNoteOn() || message.isNoteOff()))
+        {
+            output.addEvent(message, sample);
+            return;
+        }
+
+        auto key = message.getNoteNumber();
+        auto channel = message.getChannel();
+
+        if (message.isNoteOff())
+        {
+            // Every note this key produced, straight through or in the arpeggiator's set
+            for (int i = numHeld; --i >= 0;)
+            {
+                if (held[(size_t) i].key == key && held[(size_t) i].channel == channel)
+                {
+                    if (settings.arpMode == ArpMode::off)
+                        output.addEvent(juce::MidiMessage::noteOff(channel, held[(size_t) i].note), sample);
+
+                    removeHeld(i);
+                }
+            }
+
+            updateSorted();
+
+            if (numHeld == 0)
+            {
+                stopArpNotes(sample);
+                arpIndex = 0;
+            }
+
+            return;
+        }
+
+        // Expand the key by the chord shape, then quantise each note to the scale
+        auto shape = settings.chordMemory ? chordShape.load() : 1u;
+
+        for (int interval = 0, added = 0; interval < 32 && added < maxChordIntervals; ++interval)
+        {
+            if ((shape & (1u << interval)) == 0)
+                continue;
+
+            auto note = key + interval;
+            if (settings.scaleQuantise)
+                note = quantise(note);
+
+            if (note < 0 || note > 127 || numHeld >= maxHeldNotes)
+                continue;
+
+            held[(size_t) numHeld++] = { note, key, channel, message.getFloatVelocity() };
+            ++added;
+
+            if (settings.arpMode == ArpMode::off)
+                output.addEvent(juce::MidiMessage::noteOn(channel, note, message.getFloatVelocity()), sample);
+        }
+
+        updateSorted();
+    }
+
+    void removeHeld(int index)
+    {
+        for (int i = index; i < numHeld - 1; ++i)
+            held[(size_t) i] = held[(size_t) i + 1];
+
+        --numHeld;
+    }
+
+    void updateSorted()
+    {
+        numSorted = 0;
+        juce::uint32 shape = 0;
+        auto lowestKey = 128;
+
+        for (int i = 0; i < numHeld; ++i)
+            lowestKey = juce::jmin(lowestKey, held[(size_t) i].key);
+
+        for (int i = 0; i < numHeld; ++i)
+        {
+            auto& note = held[(size_t) i];
+
+            if (note.key - lowestKey < 32)
+                shape |= 1u << (note.key - lowestKey);
+
+            // Insertion sort, skipping notes two keys both produced
+            int position = 0;
+            while (position < numSorted && sorted[(size_t) position].note < note.note)
+                ++position;
+
+            if (position < numSorted && sorted[(size_t) position].note == note.note)
+                continue;
+
+            for (int j = numSorted; j > position; --j)
+                sorted[(size_t) j] = sorted[(size_t) j - 1];
+
+            sorted[(size_t) position] = note;
+            ++numSorted;
+        }
+
+        heldShape.store(shape);
+    }
+
+    int quantise(int note) const
+    {
+        auto packed = scale.load();
+        auto root = (int) (packed >> 16);
+        auto mask = packed & 0xfff;
+        if (mask == 0)
+            return note;
+
+        // Nearest scale note, the lower one on a tie
+        for (int distance = 0; distance < 12; ++distance)
+        {
+            for (auto candidate : { note - distance, note + distance })
+            {
+                auto pitchClass = ((candidate - root) % 12 + 12) % 12;
+                if ((mask & (1u << pitchClass)) != 0)
+                    return candidate;
+            }
+        }
+
+        return note;
+    }
+
+    void playArpStep(int sample, const Settings& settings)
+    {
+        stopArpNotes(sample);
+
+        if (numSorted == 0)
+            return;
+
+        auto octaves = juce::jlimit(1, 4, settings.arpOctaves);
+
+        if (settings.arpMode == ArpMode::chord)
+        {
+            auto octave = arpIndex++ % octaves;
+            for (int i = 0; i < numSorted; ++i)
+                startArpNote(sorted[(size_t) i], octave, sample);
+
+            return;
+        }
+
+        // As played walks the press order; the other modes walk the sorted notes
+        auto asPlayed = settings.arpMode == ArpMode::asPlayed;
+        const auto& source = asPlayed ? held : sorted;
+        auto count = asPlayed ? numHeld : numSorted;
+        auto length = count * octaves;
+
+        int position = 0;
+        switch (settings.arpMode)
+        {
+            case ArpMode::down:
+                position = length - 1 - arpIndex % length;
+                break;
+
+            case ArpMode::upDown:
+            {
+                auto period = juce::jmax(1, 2 * length - 2);
+                auto phase = arpIndex % period;
+                position = phase < length ? phase : period - phase;
+                break;
+            }
+
+            case ArpMode::random:
+                position = random.nextInt(length);
+                break;
+
+            case ArpMode::asPlayed:
+            case ArpMode::up:
+            case ArpMode::off:
+            case ArpMode::chord:
+            default:
+                position = arpIndex % length;
+                break;
+        }
+
+        ++arpIndex;
+        startArpNote(source[(size_t) (position % count)], position / count, sample);
+    }
+
+    void startArpNote(const HeldNote& note, int octave, int sample)
+    {
+        auto pitch = note.note + 12 * octave;
+        if (pitch > 127 || numArpNotes >= maxHeldNotes)
+            return;
+
+        output.addEvent(juce::MidiMessage::noteOn(note.channel, pitch, note.velocity), sample);
+        arpNotes[(size_t) numArpNotes++] = { pitch, note.key, note.channel, note.velocity };
+    }
+
+    void stopArpNotes(int sample)
+    {
+        for (int i = 0; i < numArpNotes; ++i)
+            output.addEvent(juce::MidiMessage::noteOff(arpNotes[(size_t) i].channel, arpNotes[(size_t) i].note), sample);
+
+        numArpNotes = 0;
+    }
+
+    void releaseAll(int sample)
+    {
+        stopArpNotes(sample);
+
+        if (lastMode == ArpMode::off)
+            for (int i = 0; i < numHeld; ++i)
+                output.addEvent(juce::MidiMessage::noteOff(held[(size_t) i].channel, held[(size_t) i].note), sample);
+    }
+};
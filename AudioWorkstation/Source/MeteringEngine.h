@@ -0,0 +1,404 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+
+// Output metering, run at the end of processBlock: per-channel peak and RMS,
+// 4x oversampled true-peak, mid/side levels and correlation, and EBU R128
+// momentary / short-term / integrated loudness (ITU-R BS.1770 K-weighting and
+// gating). Readings are published as individual atomics so the editor can
+// poll them at any rate without locking.
+class MeteringEngine
+{
+public:
+    struct Readings
+    {
+        std::array<float, 2> peakDb {}, rmsDb {}, truePeakDb {};
+        float truePeakMaxDb = -100.0f;    // Highest true-peak since the last reset
+        float midRmsDb = -100.0f, sideRmsDb = -100.0f;
+        float correlation = 0.0f;         // -1 (out of phase) .. +1 (mono)
+        float momentaryLufs = -100.0f, shortTermLufs = -100.0f, integratedLufs = -100.0f;
+    };
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = spec.sampleRate;
+
+        weighted.setSize(2, (int) spec.maximumBlockSize);
+        truePeakOversampler.initProcessing(spec.maximumBlockSize);
+
+        auto monoSpec = spec;
+        monoSpec.numChannels = 1;
+
+        for (auto& channel : kWeighting)
+        {
+            channel.shelf.coefficients = makeShelfCoefficients(sampleRate);
+            channel.highPass.coefficients = makeHighPassCoefficients(sampleRate);
+            channel.shelf.prepare(monoSpec);
+            channel.highPass.prepare(monoSpec);
+        }
+
+        // Ballistics per block are derived from the block length in process()
+        subBlockLength = juce::roundToInt(sampleRate * 0.1);
+
+        reset();
+    }
+
+    void reset()
+    {
+        truePeakOversampler.reset();
+
+        for (auto& channel : kWeighting)
+        {
+            channel.shelf.reset();
+            channel.highPass.reset();
+        }
+
+        peak.fill(0.0f);
+        meanSquare.fill(0.0f);
+        truePeak.fill(0.0f);
+        averageLeftRight = averageLeftLeft = averageRightRight = 0.0f;
+
+        subBlockEnergy = 0.0;
+        subBlockPosition = 0;
+        subBlocks.fill(0.0);
+        subBlockIndex = 0;
+        subBlocksFilled = 0;
+
+        resetIntegrated();
+        publish();
+    }
+
+    // Safe from any thread; the audio thread clears the gating history on its next block
+    void requestIntegratedReset() { integratedResetPending = true; }
+
+    void process(const juce::AudioBuffer<float>& buffer) noexcept
+    {
+        auto numSamples = buffer.getNumSamples();
+        auto numChannels = juce::jmin(2, buffer.getNumChannels());
+
+        if (numSamples == 0 || numChannels == 0 || numSamples > weighted.getNumSamples())
+            return;
+
+        if (integratedResetPending.exchange(false))
+            resetIntegrated();
+
+        const float* left = buffer.getReadPointer(0);
+        const float* right = buffer.getReadPointer(numChannels > 1 ? 1 : 0);
+
+        // Exponential ballistics: 300ms RMS / correlation averaging, 20dB/s peak release
+        auto blockSeconds = (float) (numSamples / sampleRate);
+        auto averaging = 1.0f - std::exp(-blockSeconds / 0.3f);
+        auto release = juce::Decibels::decibelsToGain(-20.0f * blockSeconds);
+
+        // Power and cross-power in one pass; mid and side power fall out of these
+        float sumLeft = 0.0f, sumRight = 0.0f, sumCross = 0.0f;
+        sumPowers(left, right, numSamples, sumLeft, sumRight, sumCross);
+
+        const float* channels[2] = { left, right };
+        const float sums[2] = { sumLeft, sumRight };
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(channels[channel], numSamples);
+            auto blockPeak = juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd()));
+
+            peak[(size_t) channel] = juce::jmax(blockPeak, peak[(size_t) channel] * release);
+            meanSquare[(size_t) channel] += averaging * (sums[channel] / (float) numSamples - meanSquare[(size_t) channel]);
+        }
+
+        averageLeftLeft += averaging * (sumLeft / (float) numSamples - averageLeftLeft);
+        averageRightRight += averaging * (sumRight / (float) numSamples - averageRightRight);
+        averageLeftRight += averaging * (sumCross / (float) numSamples - averageLeftRight);
+
+        measureTruePeak(buffer, numChannels, release);
+        measureLoudness(left, right, numSamples);
+        publish();
+    }
+
+    Readings getReadings() const noexcept
+    {
+        Readings readings;
+
+        for (size_t channel = 0; channel < 2; ++channel)
+        {
+            readings.peakDb[channel] = published.peakDb[channel].load();
+            readings.rmsDb[channel] = published.rmsDb[channel].load();
+            readings.truePeakDb[channel] = published.truePeakDb[channel].load();
+        }
+
+        readings.truePeakMaxDb = published.truePeakMaxDb.load();
+        readings.midRmsDb = published.midRmsDb.load();
+        readings.sideRmsDb = published.sideRmsDb.load();
+        readings.correlation = published.correlation.load();
+        readings.momentaryLufs = published.momentaryLufs.load();
+        readings.shortTermLufs = published.shortTermLufs.load();
+        readings.integratedLufs = published.integratedLufs.load();
+        return readings;
+    }
+
+private:
+    static constexpr float floorDb = -100.0f;
+
+    // Integrated loudness keeps a histogram of gating-block energies in 0.1 LU
+    // bins from the -70 LUFS absolute gate up to +5 LUFS, so memory and the
+    // gating cost stay fixed however long the session runs
+    static constexpr float histogramMinLufs = -70.0f;
+    static constexpr float histogramStepLu = 0.1f;
+    static constexpr int histogramBins = 750;
+
+    struct KWeighting
+    {
+        juce::dsp::IIR::Filter<float> shelf, highPass;
+    };
+
+    struct Published
+    {
+        std::array<std::atomic<float>, 2> peakDb, rmsDb, truePeakDb;
+        std::atomic<float> truePeakMaxDb { floorDb };
+        std::atomic<float> midRmsDb { floorDb }, sideRmsDb { floorDb }, correlation { 0.0f };
+        std::atomic<float> momentaryLufs { floorDb }, shortTermLufs { floorDb }, integratedLufs { floorDb };
+    };
+
+    double sampleRate = 44100.0;
+
+    juce::AudioBuffer<float> weighted;
+    std::array<KWeighting, 2> kWeighting;
+    juce::dsp::Oversampling<float> truePeakOversampler { 2, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, false };
+
+    std::array<float, 2> peak {}, meanSquare {}, truePeak {};
+    float truePeakMax = 0.0f;
+    float averageLeftRight = 0.0f, averageLeftLeft = 0.0f, averageRightRight = 0.0f;
+
+    // 100ms sub-blocks; 4 make a 400ms momentary / gating block, 30 a 3s short-term window
+    int subBlockLength = 4410;
+    int subBlockPosition = 0;
+    double subBlockEnergy = 0.0;
+    std::array<double, 30> subBlocks {};
+    int subBlockIndex = 0;
+    int subBlocksFilled = 0;
+
+    std::array<int, histogramBins> histogramCounts {};
+    std::array<double, histogramBins> histogramEnergy {};
+    std::atomic<bool> integratedResetPending { false };
+
+    Published published;
+
+    // ITU-R BS.1770 stage 1: high shelf modelling the head, recalculated for any sample rate
+    static juce::dsp::IIR::Coefficients<float>::Ptr makeShelfCoefficients(double fs)
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        auto k = std::tan(juce::MathConstants<double>::pi * f0 / fs);
+        auto vh = std::pow(10.0, gainDb / 20.0);
+        auto vb = std::pow(vh, 0.4996667741545416);
+        auto a0 = 1.0 + k / q + k * k;
+
+        return new juce::dsp::IIR::Coefficients<float>((float) ((vh + vb * k / q + k * k) / a0),
+                                                       (float) (2.0 * (k * k - vh) / a0),
+                                                       (float) ((vh - vb * k / q + k * k) / a0),
+                                                       1.0f,
+                                                       (float) (2.0 * (k * k - 1.0) / a0),
+                                                       (float) ((1.0 - k / q + k * k) / a0));
+    }
+
+    // Stage 2: the RLB high-pass
+    static juce::dsp::IIR::Coefficients<float>::Ptr makeHighPassCoefficients(double fs)
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        auto k = std::tan(juce::MathConstants<double>::pi * f0 / fs);
+        auto a0 = 1.0 + k / q + k * k;
+
+        return new juce::dsp::IIR::Coefficients<float>(1.0f, -2.0f, 1.0f, 1.0f,
+                                                       (float) (2.0 * (k * k - 1.0) / a0),
+                                                       (float) ((1.0 - k / q + k * k) / a0));
+    }
+
+    static float toDb(float gain) noexcept
+    {
+        return juce::Decibels::gainToDecibels(gain, floorDb);
+    }
+
+    static float toLufs(double meanSquareSum) noexcept
+    {
+        return meanSquareSum > 0.0 ? juce::jmax(floorDb, (float) (-0.691 + 10.0 * std::log10(meanSquareSum))) : floorDb;
+    }
+
+    // Four independent accumulators keep the loop free of a serial dependency so it vectorises
+    static void sumPowers(const float* left, const float* right, int numSamples,
+                          float& sumLeft, float& sumRight, float& sumCross) noexcept
+    {
+        float ll[4] {}, rr[4] {}, lr[4] {};
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                auto l = left[i + lane], r = right[i + lane];
+                ll[lane] += l * l;
+                rr[lane] += r * r;
+                lr[lane] += l * r;
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            ll[0] += left[i] * left[i];
+            rr[0] += right[i] * right[i];
+            lr[0] += left[i] * right[i];
+        }
+
+        sumLeft = ll[0] + ll[1] + ll[2] + ll[3];
+        sumRight = rr[0] + rr[1] + rr[2] + rr[3];
+        sumCross = lr[0] + lr[1] + lr[2] + lr[3];
+    }
+
+    void measureTruePeak(const juce::AudioBuffer<float>& buffer, int numChannels, float release) noexcept
+    {
+        juce::dsp::AudioBlock<const float> block(buffer.getArrayOfReadPointers(), (size_t) numChannels,
+                                                 (size_t) buffer.getNumSamples());
+        auto oversampled = truePeakOversampler.processSamplesUp(block);
+
+        for (size_t channel = 0; channel < 2; ++channel)
+        {
+            auto source = juce::jmin(channel, oversampled.getNumChannels() - 1);
+            auto range = juce::FloatVectorOperations::findMinAndMax(oversampled.getChannelPointer(source),
+                                                                    (int) oversampled.getNumSamples());
+            auto blockPeak = juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd()));
+
+            truePeak[channel] = juce::jmax(blockPeak, truePeak[channel] * release);
+            truePeakMax = juce::jmax(truePeakMax, blockPeak);
+        }
+    }
+
+    void measureLoudness(const float* left, const float* right, int numSamples) noexcept
+    {
+        weighted.copyFrom(0, 0, left, numSamples);
+        weighted.copyFrom(1, 0, right, numSamples);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto* data = weighted.getWritePointer(channel);
+            auto& filters = kWeighting[(size_t) channel];
+
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = filters.highPass.processSample(filters.shelf.processSample(data[i]));
+        }
+
+        const float* weightedLeft = weighted.getReadPointer(0);
+        const float* weightedRight = weighted.getReadPointer(1);
+        int position = 0;
+
+        // Split the block at 100ms sub-block boundaries
+        while (position < numSamples)
+        {
+            auto count = juce::jmin(numSamples - position, subBlockLength - subBlockPosition);
+            float sumLeft = 0.0f, sumRight = 0.0f, sumCross = 0.0f;
+            sumPowers(weightedLeft + position, weightedRight + position, count, sumLeft, sumRight, sumCross);
+
+            // BS.1770 channel weights are 1.0 for left and right
+            subBlockEnergy += (double) sumLeft + (double) sumRight;
+            subBlockPosition += count;
+            position += count;
+
+            if (subBlockPosition >= subBlockLength)
+                finishSubBlock();
+        }
+    }
+
+    void finishSubBlock() noexcept
+    {
+        subBlocks[(size_t) subBlockIndex] = subBlockEnergy / (double) subBlockLength;
+        subBlockIndex = (subBlockIndex + 1) % (int) subBlocks.size();
+        subBlocksFilled = juce::jmin(subBlocksFilled + 1, (int) subBlocks.size());
+        subBlockEnergy = 0.0;
+        subBlockPosition = 0;
+
+        auto momentary = averageSubBlocks(4);
+        auto shortTerm = averageSubBlocks((int) subBlocks.size());
+
+        published.momentaryLufs = subBlocksFilled >= 4 ? toLufs(momentary) : floorDb;
+        published.shortTermLufs = subBlocksFilled >= (int) subBlocks.size() ? toLufs(shortTerm) : floorDb;
+
+        // Each 100ms step completes a 400ms gating block with 75% overlap
+        if (subBlocksFilled >= 4)
+            addGatingBlock(momentary);
+    }
+
+    double averageSubBlocks(int count) const noexcept
+    {
+        count = juce::jmin(count, subBlocksFilled);
+        if (count == 0)
+            return 0.0;
+
+        double sum = 0.0;
+        for (int i = 1; i <= count; ++i)
+            sum += subBlocks[(size_t) ((subBlockIndex - i + (int) subBlocks.size()) % (int) subBlocks.size())];
+
+        return sum / count;
+    }
+
+    void addGatingBlock(double energy) noexcept
+    {
+        auto loudness = toLufs(energy);
+        if (loudness < histogramMinLufs)
+            return; // Absolute gate
+
+        auto bin = juce::jmin(histogramBins - 1, (int) ((loudness - histogramMinLufs) / histogramStepLu));
+        ++histogramCounts[(size_t) bin];
+        histogramEnergy[(size_t) bin] += energy;
+
+        // Relative gate: 10 LU below the mean of everything above the absolute gate
+        double total = 0.0;
+        int count = 0;
+        for (int i = 0; i < histogramBins; ++i)
+        {
+            total += histogramEnergy[(size_t) i];
+            count += histogramCounts[(size_t) i];
+        }
+
+        auto relativeGate = toLufs(total / count) - 10.0f;
+        auto firstBin = juce::jlimit(0, histogramBins - 1, (int) std::ceil((relativeGate - histogramMinLufs) / histogramStepLu));
+
+        total = 0.0;
+        count = 0;
+        for (int i = firstBin; i < histogramBins; ++i)
+        {
+            total += histogramEnergy[(size_t) i];
+            count += histogramCounts[(size_t) i];
+        }
+
+        published.integratedLufs = count > 0 ? toLufs(total / count) : floorDb;
+    }
+
+    void resetIntegrated() noexcept
+    {
+        histogramCounts.fill(0);
+        histogramEnergy.fill(0.0);
+        truePeakMax = 0.0f;
+        published.integratedLufs = floorDb;
+        published.truePeakMaxDb = floorDb;
+    }
+
+    void publish() noexcept
+    {
+        for (size_t channel = 0; channel < 2; ++channel)
+        {
+            published.peakDb[channel] = toDb(peak[channel]);
+            published.rmsDb[channel] = toDb(std::sqrt(meanSquare[channel]));
+            published.truePeakDb[channel] = toDb(truePeak[channel]);
+        }
+
+        published.truePeakMaxDb = toDb(truePeakMax);
+
+        // M = (L+R)/2, S = (L-R)/2
+        auto midPower = (averageLeftLeft + averageRightRight + 2.0f * averageLeftRight) * 0.25f;
+        auto sidePower = (averageLeftLeft + averageRightRight - 2.0f * averageLeftRight) * 0.25f;
+        published.midRmsDb = toDb(std::sqrt(juce::jmax(0.0f, midPower)));
+        published.sideRmsDb = toDb(std::sqrt(juce::jmax(0.0f, sidePower)));
+
+        auto denominator = std::sqrt(averageLeftLeft * averageRightRight);
+        published.correlation = denominator > 1.0e-9f ? juce::jlimit(-1.0f, 1.0f, averageLeftRight / denominator) : 0.0f;
+    }
+};
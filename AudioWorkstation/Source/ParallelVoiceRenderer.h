@@ -0,0 +1,278 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <ctime>
+ #include <semaphore.h>
+#endif
+
+// Renders a synth's active voices on several cores. A fixed pool of real-time
+// worker threads is started in prepare(); the audio thread never creates,
+// joins or locks anything while rendering. Sleeping workers are woken through
+// an OS semaphore whose post is lock-free (juce::WaitableEvent takes a mutex).
+//
+// Each render deals the active voices round-robin (in voice order) into one
+// group per core, publishes the job and works on groups itself alongside the
+// workers. Groups are claimed from a single atomic word holding the job's
+// generation, group count and next group, so a worker that wakes late can never
+// claim a group from a job it didn't see. Every group renders into its own
+// scratch buffer and the buffers are summed in group order, so the output only
+// depends on which voices are active, never on which thread ran what.
+//
+// Below the voice threshold (or when disabled) render() returns false and the
+// caller renders serially: waking threads costs more than a few voices do.
+class ParallelVoiceRenderer
+{
+public:
+    static constexpr int maxGroups = 8;    // Audio thread plus up to 7 workers
+    static constexpr int maxVoices = 64;   // More than this renders serially
+
+    ~ParallelVoiceRenderer() { stopWorkers(); }
+
+    // Message thread, while the audio thread isn't rendering
+    void prepare(int numChannels, int maxSamples, double sampleRate, int samplesPerBlock)
+    {
+        stopWorkers();
+
+        numGroups = juce::jlimit(1, maxGroups, juce::SystemStats::getNumCpus());
+        scratchSamples = maxSamples;
+
+        for (int group = 0; group < numGroups; ++group)
+            scratch[(size_t) group].setSize(numChannels, maxSamples);
+
+        auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(samplesPerBlock, sampleRate);
+
+        for (int worker = 1; worker < numGroups; ++worker)
+        {
+            workers.push_back(std::make_unique<Worker>(*this, worker));
+            if (! workers.back()->startRealtimeThread(options))
+                workers.back()->startThread(juce::Thread::Priority::highest);
+        }
+    }
+
+    // Audio thread, before rendering
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+    void setVoiceThreshold(int numVoices) noexcept { voiceThreshold = juce::jmax(2, numVoices); }
+
+    // Adds the active voices into output; false (having done nothing) when they should render serially
+    bool render(const juce::OwnedArray<juce::SynthesiserVoice>& voices, juce::AudioBuffer<float>& output,
+                int startSample, int numSamples)
+    {
+        if (! enabled || numGroups < 2 || numSamples > scratchSamples
+            || output.getNumChannels() > scratch[0].getNumChannels() || voices.size() > maxVoices)
+            return false;
+
+        int numActive = 0;
+        for (auto* voice : voices)
+            if (voice->isVoiceActive())
+                ++numActive;
+
+        if (numActive < voiceThreshold)
+            return false;
+
+        auto jobGroups = juce::jmin(numGroups, numActive);
+        groupSizes.fill(0);
+
+        int index = 0;
+        for (auto* voice : voices)
+        {
+            if (voice->isVoiceActive())
+            {
+                auto group = (size_t) (index++ % jobGroups);
+                groupVoices[group][(size_t) groupSizes[group]++] = voice;
+            }
+        }
+
+        jobChannels = output.getNumChannels();
+        jobSamples = numSamples;
+
+        // Publish: everything above is visible to whoever sees the new generation
+        generation = (generation + 1) & 0xffffffffu;
+        groupsRemaining.store(jobGroups, std::memory_order_relaxed);
+        job.store((generation << 32) | ((juce::uint64) jobGroups << 16));
+
+        // Sequentially consistent with the worker's sleeping flag, so a worker either sees the job or gets woken
+        for (auto& worker : workers)
+            if (worker->sleeping.load())
+                worker->wake.post();
+
+        runGroups(generation);
+
+        // Groups a worker has claimed but not finished are the only thing left to wait for
+        while (groupsRemaining.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+
+        for (int group = 0; group < jobGroups; ++group)
+            for (int channel = 0; channel < jobChannels; ++channel)
+                output.addFrom(channel, startSample, scratch[(size_t) group].getReadPointer(channel), numSamples);
+
+        return true;
+    }
+
+private:
+    // Counting semaphore for waking a worker. Posting never blocks or takes a
+    // lock: an atomic increment, plus a kernel call only when a thread waits.
+    class WakeSemaphore
+    {
+    public:
+       #if JUCE_MAC || JUCE_IOS
+        WakeSemaphore() : semaphore(dispatch_semaphore_create(0)) {}
+        ~WakeSemaphore() { dispatch_release(semaphore); }
+        void post() noexcept { dispatch_semaphore_signal(semaphore); }
+        void wait(int milliseconds) noexcept
+        {
+            dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t) milliseconds * 1000000));
+        }
+
+    private:
+        dispatch_semaphore_t semaphore;
+       #elif JUCE_WINDOWS
+        WakeSemaphore() : semaphore(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+        ~WakeSemaphore() { CloseHandle(semaphore); }
+        void post() noexcept { ReleaseSemaphore(semaphore, 1, nullptr); }
+        void wait(int milliseconds) noexcept { WaitForSingleObject(semaphore, (DWORD) milliseconds); }
+
+    private:
+        HANDLE semaphore;
+       #else
+        WakeSemaphore() { sem_init(&semaphore, 0, 0); }
+        ~WakeSemaphore() { sem_destroy(&semaphore); }
+        void post() noexcept { sem_post(&semaphore); }
+        void wait(int milliseconds) noexcept
+        {
+            timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += milliseconds / 1000;
+            deadline.tv_nsec += (long) (milliseconds % 1000) * 1000000;
+            if (deadline.tv_nsec >= 1000000000)
+            {
+                ++deadline.tv_sec;
+                deadline.tv_nsec -= 1000000000;
+            }
+
+            sem_timedwait(&semaphore, &deadline); // Timeouts and interruptions just go round the worker's loop
+        }
+
+    private:
+        sem_t semaphore;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(WakeSemaphore)
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(ParallelVoiceRenderer& rendererToUse, int index)
+            : juce::Thread("Voice renderer " + juce::String(index)), renderer(rendererToUse) {}
+
+        void run() override
+        {
+            juce::ScopedNoDenormals noDenormals;
+            auto seen = renderer.job.load(std::memory_order_acquire) >> 32;
+
+            while (! threadShouldExit())
+            {
+                // Spin a little for the next job, then sleep until the audio thread wakes us
+                for (int spin = 0; spin < spinCount && (renderer.job.load(std::memory_order_acquire) >> 32) == seen; ++spin)
+                    std::this_thread::yield();
+
+                auto current = renderer.job.load(std::memory_order_acquire) >> 32;
+                if (current == seen)
+                {
+                    sleeping.store(true);
+                    if ((renderer.job.load() >> 32) == seen)
+                        wake.wait(100);
+                    sleeping.store(false);
+                    continue;
+                }
+
+                seen = current;
+                renderer.runGroups(current);
+            }
+        }
+
+        std::atomic<bool> sleeping { false };
+        WakeSemaphore wake;
+
+    private:
+        static constexpr int spinCount = 64;
+        ParallelVoiceRenderer& renderer;
+    };
+
+    // Generation (high 32 bits), group count (bits 16-31) and next unclaimed group (low 16 bits)
+    std::atomic<juce::uint64> job { 0 };
+    std::atomic<int> groupsRemaining { 0 };
+    juce::uint64 generation = 0;
+
+    bool enabled = false;
+    int voiceThreshold = 8;
+    int numGroups = 1;
+    int scratchSamples = 0;
+    int jobChannels = 0, jobSamples = 0;
+
+    std::array<juce::AudioBuffer<float>, maxGroups> scratch;
+    std::array<std::array<juce::SynthesiserVoice*, maxVoices>, maxGroups> groupVoices {};
+    std::array<int, maxGroups> groupSizes {};
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    void runGroups(juce::uint64 jobGeneration)
+    {
+        for (;;)
+        {
+            auto current = job.load(std::memory_order_acquire);
+            int group;
+
+            // Claim the next group of this job, unless the job has moved on or run out
+            do
+            {
+                group = (int) (current & 0xffff);
+                if ((current >> 32) != jobGeneration || group >= (int) ((current >> 16) & 0xffff))
+                    return;
+            }
+            while (! job.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+
+            renderGroup(group);
+            groupsRemaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void renderGroup(int group)
+    {
+        auto& buffer = scratch[(size_t) group];
+        juce::AudioBuffer<float> target(buffer.getArrayOfWritePointers(), jobChannels, jobSamples);
+        target.clear();
+
+        for (int i = 0; i < groupSizes[(size_t) group]; ++i)
+            groupVoices[(size_t) group][(size_t) i]->renderNextBlock(target, 0, jobSamples);
+    }
+
+    void stopWorkers()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        for (auto& worker : workers)
+        {
+            worker->wake.post();
+            worker->stopThread(1000);
+        }
+
+        workers.clear();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(ParallelVoiceRenderer)
+};
@@ -0,0 +1,397 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <map>
+#include <vector>
+
+// Scales and patterns for the built-in sequencer: the seven modes, the five
+// melody patterns and the default chord, bass and drum lanes, plus anything
+// defined in a user JSON file:
+//
+//   { "scales":   [ { "name": "Blues", "intervals": [0, 3, 5, 6, 7, 10] } ],
+//     "patterns": [ { "name": "Pulse",
+//                     "steps": [0, "tie", { "degree": 4, "ratchet": 3 }, "rest",
+//                               { "degree": 7, "velocity": 1.0, "probability": 0.5, "chord": true }] } ],
+//     "lanes":    { "bass": { "pattern": "Pulse", "length": 5, "swing": 0.2 },
+//                   "percussion": { "enabled": true } } }
+//
+// A step is a scale degree (degrees past the end of the scale continue into the
+// next octave, negative ones into the octave below), "rest", "tie" (hold the
+// previous step's notes) or an object with a degree and optional velocity,
+// probability (0-1), ratchet (retriggers within the step) and chord (add the
+// third and fifth on the melody lane). Unset velocities follow the built-in
+// 16-step accents. On the percussion lane the degree picks a kit piece.
+//
+// "lanes" sets the pattern, length, swing and on/off state of the melody,
+// chords, bass and percussion lanes (see StepSequencer.h); anything left out
+// keeps its default.
+//
+// A (pattern, scale) pair is compiled on first use into a flat StepTable of
+// semitone offsets from the root, so the audio thread does no lookups or scale
+// arithmetic and can't index out of range. All methods are for the message
+// thread; the processor hands compiled tables to the audio thread.
+class PatternLibrary
+{
+public:
+    static constexpr int maxSteps = 64;
+    static constexpr int maxRatchets = 8;
+    static constexpr int maxScaleSize = 12;
+    static constexpr int maxLanes = 4;
+
+    struct Step
+    {
+        enum Type : juce::uint8 { note, rest, tie };
+
+        Type type = rest;
+        juce::uint8 ratchets = 1;
+        bool chord = false;
+        int degree = 0;
+        int offset = 0, thirdOffset = 0, fifthOffset = 0; // Semitones from the root
+        float velocity = 0.8f;
+        float probability = 1.0f;
+    };
+
+    // Fixed size, so tables are copied between threads without allocating
+    struct StepTable
+    {
+        std::array<Step, maxSteps> steps {};
+        int numSteps = 0;
+    };
+
+    // A lane's entry in the file's "lanes" object; unset fields are negative or empty
+    struct LaneDefinition
+    {
+        juce::String pattern;
+        int length = -1;
+        float swing = -1.0f;
+        int enabled = -1;
+    };
+
+    PatternLibrary()
+    {
+        juce::String error;
+        parse({}, error);
+    }
+
+    static juce::File getDefaultFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                   .getChildFile("Turbeaux Sounds").getChildFile("Konda").getChildFile("Patterns.json");
+    }
+
+    // Replaces the user scales and patterns. A missing file leaves just the
+    // built-ins; a file with errors leaves the library as it was.
+    bool load(const juce::File& file, juce::String& error)
+    {
+        if (! file.existsAsFile())
+            return parse({}, error);
+
+        juce::var json;
+        auto result = juce::JSON::parse(file.loadFileAsString(), json);
+        if (result.failed())
+        {
+            error = file.getFileName() + ": " + result.getErrorMessage();
+            return false;
+        }
+
+        return parse(json, error);
+    }
+
+    int getNumScales() const { return (int) scales.size(); }
+    int getNumPatterns() const { return (int) patterns.size(); }
+
+    juce::StringArray getScaleNames() const
+    {
+        juce::StringArray names;
+        for (auto& scale : scales)
+            names.add(scale.name);
+        return names;
+    }
+
+    juce::StringArray getPatternNames() const
+    {
+        juce::StringArray names;
+        for (auto& pattern : patterns)
+            names.add(pattern.name);
+        return names;
+    }
+
+    // Index of the named pattern, or -1
+    int findPattern(const juce::String& name) const
+    {
+        for (size_t i = 0; i < patterns.size(); ++i)
+            if (patterns[i].name == name)
+                return (int) i;
+
+        return -1;
+    }
+
+    // The file's settings for a lane ("melody", "chords", "bass" or "percussion")
+    LaneDefinition getLaneDefinition(const juce::String& laneName) const
+    {
+        for (auto& lane : lanes)
+            if (lane.first == laneName)
+                return lane.second;
+
+        return {};
+    }
+
+    // Bit n set when the scale contains n semitones above the root (any octave)
+    juce::uint16 getScalePitchClasses(int scaleIndex) const
+    {
+        juce::uint16 mask = 0;
+        for (auto interval : scales[(size_t) juce::jlimit(0, getNumScales() - 1, scaleIndex)].intervals)
+            mask |= (juce::uint16) (1u << (((interval % 12) + 12) % 12));
+
+        return mask;
+    }
+
+    // Compiled the first time a combination is asked for; indices are clamped
+    const StepTable& getTable(int patternIndex, int scaleIndex)
+    {
+        patternIndex = juce::jlimit(0, getNumPatterns() - 1, patternIndex);
+        scaleIndex = juce::jlimit(0, getNumScales() - 1, scaleIndex);
+
+        auto& table = compiled[{ patternIndex, scaleIndex }];
+        if (table == nullptr)
+            table = std::make_unique<StepTable>(compile(patterns[(size_t) patternIndex], scales[(size_t) scaleIndex]));
+
+        return *table;
+    }
+
+private:
+    struct Scale
+    {
+        juce::String name;
+        std::vector<int> intervals;
+    };
+
+    struct StepDefinition
+    {
+        Step::Type type = Step::rest;
+        int degree = 0;
+        float velocity = -1.0f; // Negative: use the accent pattern
+        float probability = 1.0f;
+        int ratchets = 1;
+        bool chord = false;
+    };
+
+    struct Pattern
+    {
+        juce::String name;
+        std::vector<StepDefinition> steps;
+    };
+
+    std::vector<Scale> scales;
+    std::vector<Pattern> patterns;
+    std::vector<std::pair<juce::String, LaneDefinition>> lanes;
+    std::map<std::pair<int, int>, std::unique_ptr<StepTable>> compiled;
+
+    bool parse(const juce::var& json, juce::String& error)
+    {
+        std::vector<Scale> newScales {
+            { "Major",      { 0, 2, 4, 5, 7, 9, 11 } }, // Ionian
+            { "Minor",      { 0, 2, 3, 5, 7, 9, 10 } }, // Natural minor/Aeolian
+            { "Dorian",     { 0, 2, 3, 5, 7, 8, 10 } },
+            { "Phrygian",   { 0, 1, 3, 5, 7, 8, 10 } },
+            { "Lydian",     { 0, 2, 4, 6, 7, 9, 11 } },
+            { "Mixolydian", { 0, 2, 4, 5, 7, 9, 10 } },
+            { "Locrian",    { 0, 1, 3, 5, 6, 8, 10 } },
+        };
+
+        std::vector<Pattern> newPatterns;
+        constexpr int restStep = std::numeric_limits<int>::min();
+        auto addBuiltIn = [&newPatterns](const char* name, std::initializer_list<int> degrees)
+        {
+            Pattern pattern { name, {} };
+            for (auto degree : degrees)
+            {
+                StepDefinition step;
+                step.type = degree == restStep ? Step::rest : Step::note;
+                step.degree = degree == restStep ? 0 : degree;
+                pattern.steps.push_back(step);
+            }
+            newPatterns.push_back(std::move(pattern));
+        };
+
+        addBuiltIn("Scale",        { 0, 1, 2, 3, 4, 5, 6, 7, 6, 5, 4, 3, 2, 1, 0, 0 });
+        addBuiltIn("Arpeggios",    { 0, 2, 4, 2, 0, 3, 5, 3, 0, 4, 6, 4, 0, 7, 0, 0 });
+        addBuiltIn("Chord Tones",  { 0, 4, 7, 4, 0, 3, 6, 3, 0, 5, 7, 5, 0, 2, 0, 0 });
+        addBuiltIn("Step Pattern", { 0, 2, 1, 3, 2, 4, 3, 5, 4, 6, 5, 7, 6, 7, 6, 5 });
+        addBuiltIn("Cascading",    { 7, 5, 3, 1, 0, 2, 4, 6, 7, 6, 4, 2, 0, 1, 3, 5 });
+
+        // Default chord, bass and percussion lanes: the triad on every 4th step
+        // and the root under every step the generator always played, and a
+        // kick/hat/snare/hat beat
+        addBuiltIn("Downbeat Triads", { 0, restStep, restStep, restStep });
+        addBuiltIn("Root Pulse",      { 0 });
+        addBuiltIn("Basic Beat",      { 0, 2, 1, 2 });
+
+        if (auto* userScales = json.getProperty("scales", {}).getArray())
+        {
+            for (auto& entry : *userScales)
+            {
+                Scale scale { entry.getProperty("name", "Scale " + juce::String(newScales.size() + 1)).toString(), {} };
+
+                if (auto* intervals = entry.getProperty("intervals", {}).getArray())
+                    for (auto& interval : *intervals)
+                        scale.intervals.push_back((int) interval);
+
+                if (scale.intervals.empty() || (int) scale.intervals.size() > maxScaleSize)
+                {
+                    error = "Scale \"" + scale.name + "\" needs 1 to " + juce::String(maxScaleSize) + " intervals";
+                    return false;
+                }
+
+                newScales.push_back(std::move(scale));
+            }
+        }
+
+        if (auto* userPatterns = json.getProperty("patterns", {}).getArray())
+        {
+            for (auto& entry : *userPatterns)
+            {
+                Pattern pattern { entry.getProperty("name", "Pattern " + juce::String(newPatterns.size() + 1)).toString(), {} };
+
+                if (auto* steps = entry.getProperty("steps", {}).getArray())
+                {
+                    for (auto& value : *steps)
+                    {
+                        StepDefinition step;
+                        if (! parseStep(value, step))
+                        {
+                            error = "Pattern \"" + pattern.name + "\": can't read step "
+                                  + juce::String(pattern.steps.size() + 1) + " (" + juce::JSON::toString(value, true) + ")";
+                            return false;
+                        }
+
+                        pattern.steps.push_back(step);
+                    }
+                }
+
+                if (pattern.steps.empty() || (int) pattern.steps.size() > maxSteps)
+                {
+                    error = "Pattern \"" + pattern.name + "\" needs 1 to " + juce::String(maxSteps) + " steps";
+                    return false;
+                }
+
+                newPatterns.push_back(std::move(pattern));
+            }
+        }
+
+        std::vector<std::pair<juce::String, LaneDefinition>> newLanes;
+        if (auto* userLanes = json.getProperty("lanes", {}).getDynamicObject())
+        {
+            for (auto& property : userLanes->getProperties())
+            {
+                auto& entry = property.value;
+                LaneDefinition lane;
+                lane.pattern = entry.getProperty("pattern", {}).toString();
+
+                if (lane.pattern.isNotEmpty() && std::none_of(newPatterns.begin(), newPatterns.end(),
+                                                              [&lane](const Pattern& pattern) { return pattern.name == lane.pattern; }))
+                {
+                    error = "Lane \"" + property.name.toString() + "\": no pattern called \"" + lane.pattern + "\"";
+                    return false;
+                }
+
+                if (entry.hasProperty("length"))
+                    lane.length = juce::jlimit(0, maxSteps, (int) entry.getProperty("length", {}));
+                if (entry.hasProperty("swing"))
+                    lane.swing = juce::jlimit(0.0f, 0.5f, (float) entry.getProperty("swing", {}));
+                if (entry.hasProperty("enabled"))
+                    lane.enabled = (bool) entry.getProperty("enabled", {}) ? 1 : 0;
+
+                newLanes.emplace_back(property.name.toString(), lane);
+            }
+        }
+
+        scales = std::move(newScales);
+        patterns = std::move(newPatterns);
+        lanes = std::move(newLanes);
+        compiled.clear();
+        return true;
+    }
+
+    static bool parseStep(const juce::var& value, StepDefinition& step)
+    {
+        if (value.isString())
+        {
+            auto text = value.toString();
+            if (text == "rest" || text == "-")
+                step.type = Step::rest;
+            else if (text == "tie" || text == "~")
+                step.type = Step::tie;
+            else
+                return false;
+
+            return true;
+        }
+
+        if (value.isInt() || value.isInt64() || value.isDouble())
+        {
+            step.type = Step::note;
+            step.degree = (int) value;
+            return true;
+        }
+
+        auto* object = value.getDynamicObject();
+        if (object == nullptr || ! object->hasProperty("degree"))
+            return false;
+
+        step.type = Step::note;
+        step.degree = (int) object->getProperty("degree");
+
+        if (object->hasProperty("velocity"))
+            step.velocity = juce::jlimit(0.0f, 1.0f, (float) object->getProperty("velocity"));
+        if (object->hasProperty("probability"))
+            step.probability = juce::jlimit(0.0f, 1.0f, (float) object->getProperty("probability"));
+        if (object->hasProperty("ratchet"))
+            step.ratchets = juce::jlimit(1, maxRatchets, (int) object->getProperty("ratchet"));
+        if (object->hasProperty("chord"))
+            step.chord = (bool) object->getProperty("chord");
+
+        return true;
+    }
+
+    static int toSemitones(const std::vector<int>& intervals, int degree)
+    {
+        auto size = (int) intervals.size();
+        auto octave = degree >= 0 ? degree / size : -((size - 1 - degree) / size);
+        return intervals[(size_t) (degree - octave * size)] + 12 * octave;
+    }
+
+    static StepTable compile(const Pattern& pattern, const Scale& scale)
+    {
+        static const float accents[] = { 0.8f, 0.6f, 0.9f, 0.7f, 0.85f, 0.75f, 0.65f, 1.0f, 0.7f, 0.8f, 0.6f, 0.9f, 0.75f, 0.85f, 0.65f, 0.9f };
+
+        StepTable table;
+        table.numSteps = juce::jmin(maxSteps, (int) pattern.steps.size());
+
+        auto size = (int) scale.intervals.size();
+
+        for (int i = 0; i < table.numSteps; ++i)
+        {
+            auto& definition = pattern.steps[(size_t) i];
+            auto& step = table.steps[(size_t) i];
+
+            step.type = definition.type;
+            step.velocity = definition.velocity >= 0.0f ? definition.velocity : accents[i % 16];
+            step.probability = definition.probability;
+            step.ratchets = (juce::uint8) definition.ratchets;
+            step.chord = definition.chord;
+            step.degree = definition.degree;
+
+            if (step.type == Step::note)
+            {
+                // The chord is built from the degree's position in the root octave
+                auto wrapped = ((definition.degree % size) + size) % size;
+                step.offset = toSemitones(scale.intervals, definition.degree);
+                step.thirdOffset = toSemitones(scale.intervals, (wrapped + 2) % size);
+                step.fifthOffset = toSemitones(scale.intervals, (wrapped + 4) % size);
+            }
+        }
+
+        return table;
+    }
+};
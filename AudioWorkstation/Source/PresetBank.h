@@ -0,0 +1,274 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+// Preset library stored as one indexed file and read through a memory map.
+//
+// Layout (little-endian):
+//   magic "KPRB", version, numPresets, numParameters, idTableSize  (5 x int32)
+//   parameter ID table: numParameters null-terminated UTF-8 strings (idTableSize bytes)
+//   numPresets fixed-size records: 32-byte name + numParameters float32 plain values
+//
+// Fixed-size records make preset N a single offset calculation, so switching
+// only touches the pages of that one record. Presets are matched to parameters
+// by ID, so banks survive parameters being added or reordered. All methods are
+// for the message thread; the processor hands the values to the audio thread.
+//
+// Several plugin instances share the file, so every change re-reads it first
+// and rewrites the latest bank, not this instance's copy. A file that fails to
+// open (a newer version, a damaged header) is never overwritten: the next save
+// moves it aside to a .bak sibling before writing a new bank.
+class PresetBank
+{
+public:
+    static constexpr int nameSize = 32;
+
+    static juce::File getDefaultFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                   .getChildFile("Turbeaux Sounds").getChildFile("Konda").getChildFile("Presets.kpb");
+    }
+
+    // Maps the file and rebuilds the name index. A missing file is an empty bank;
+    // false (and an empty bank) when the file is there but can't be read.
+    bool open(const juce::File& bankFile)
+    {
+        file = bankFile;
+        map.reset();
+        parameterIDs.clear();
+        names.clear();
+        nameIndex.clear();
+        numPresets = numParameters = 0;
+        unreadable = false;
+
+        if (! file.existsAsFile())
+            return true;
+
+        unreadable = true; // Until the header and records check out
+
+        map = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        auto* data = static_cast<const char*>(map->getData());
+        auto size = map->getSize();
+
+        if (data == nullptr || size < headerSize || readInt(data) != magic || readInt(data + 4) != version)
+        {
+            map.reset();
+            return false;
+        }
+
+        auto presets = readInt(data + 8);
+        numParameters = readInt(data + 12);
+        auto idTableSize = readInt(data + 16);
+
+        recordStart = headerSize + (size_t) idTableSize;
+        recordSize = (size_t) nameSize + (size_t) numParameters * sizeof(float);
+
+        if (presets < 0 || numParameters < 0 || idTableSize < 0
+            || recordStart + (size_t) presets * recordSize > size)
+        {
+            map.reset();
+            return false;
+        }
+
+        // Parameter ID table
+        auto* ids = data + headerSize;
+        for (size_t offset = 0; offset < (size_t) idTableSize && parameterIDs.size() < numParameters;)
+        {
+            juce::String id(juce::CharPointer_UTF8(ids + offset));
+            offset += strnlen(ids + offset, (size_t) idTableSize - offset) + 1;
+            parameterIDs.add(id);
+        }
+
+        // Name index
+        for (int i = 0; i < presets; ++i)
+        {
+            auto* name = data + recordStart + (size_t) i * recordSize;
+            names.add(juce::String::fromUTF8(name, (int) strnlen(name, nameSize)));
+            nameIndex.set(names[i], i);
+        }
+
+        numPresets = presets;
+        unreadable = false;
+        return true;
+    }
+
+    // True when the last open() found a file it couldn't read
+    bool isUnreadable() const { return unreadable; }
+
+    int getNumPresets() const { return numPresets; }
+    juce::String getName(int index) const { return names[index]; }
+    const juce::StringArray& getNames() const { return names; }
+
+    // -1 when there's no preset with that name. Names are matched as stored,
+    // so a name longer than a record holds finds the preset it was saved as.
+    int findPreset(const juce::String& name) const
+    {
+        auto stored = getStoredName(name);
+        return nameIndex.contains(stored) ? nameIndex[stored] : -1;
+    }
+
+    // The name as a record holds it: at most nameSize - 1 bytes of UTF-8, cut between characters
+    static juce::String getStoredName(const juce::String& name)
+    {
+        char stored[nameSize] = {};
+        name.copyToUTF8(stored, nameSize);
+        return juce::String::fromUTF8(stored);
+    }
+
+    // Fills plainValues (one per ID, in the caller's order). IDs the preset
+    // doesn't know keep whatever the caller put there, typically the defaults.
+    bool readPreset(int index, const juce::StringArray& ids, float* plainValues) const
+    {
+        if (map == nullptr || ! juce::isPositiveAndBelow(index, numPresets))
+            return false;
+
+        auto* values = static_cast<const char*>(map->getData()) + recordStart + (size_t) index * recordSize + nameSize;
+
+        for (int i = 0; i < ids.size(); ++i)
+        {
+            auto column = parameterIDs.indexOf(ids[i]);
+            if (column >= 0)
+                plainValues[i] = readFloat(values + (size_t) column * sizeof(float));
+        }
+
+        return true;
+    }
+
+    // Adds (or replaces, if the name exists) a preset and rewrites the bank.
+    // defaultValues fill in parameters that existing presets predate.
+    // Returns the preset's index, or -1 if the file couldn't be written.
+    int storePreset(const juce::String& name, const juce::StringArray& ids, const float* plainValues,
+                    const float* defaultValues)
+    {
+        // Picks up presets other instances have saved since this one last looked
+        open(file);
+
+        // Existing presets are carried over into the new column layout
+        std::vector<std::vector<float>> records;
+        juce::StringArray recordNames;
+
+        for (int i = 0; i < numPresets; ++i)
+        {
+            std::vector<float> values(defaultValues, defaultValues + ids.size());
+            readPreset(i, ids, values.data());
+            records.push_back(std::move(values));
+            recordNames.add(names[i]);
+        }
+
+        auto index = findPreset(name);
+        std::vector<float> newValues(plainValues, plainValues + ids.size());
+
+        if (index >= 0)
+        {
+            records[(size_t) index] = std::move(newValues);
+        }
+        else
+        {
+            index = (int) records.size();
+            records.push_back(std::move(newValues));
+            recordNames.add(getStoredName(name));
+        }
+
+        return write(ids, recordNames, records) ? index : -1;
+    }
+
+    bool renamePreset(int index, const juce::String& newName)
+    {
+        if (! juce::isPositiveAndBelow(index, numPresets))
+            return false;
+
+        // Another instance may have changed the bank; the preset is found again by name
+        auto oldName = names[index];
+        open(file);
+        index = findPreset(oldName);
+
+        if (index < 0 || findPreset(newName) >= 0)
+            return false;
+
+        std::vector<std::vector<float>> records;
+        auto recordNames = names;
+        recordNames.set(index, getStoredName(newName));
+
+        for (int i = 0; i < numPresets; ++i)
+        {
+            std::vector<float> values((size_t) parameterIDs.size(), 0.0f);
+            readPreset(i, parameterIDs, values.data());
+            records.push_back(std::move(values));
+        }
+
+        auto ids = parameterIDs;
+        return write(ids, recordNames, records);
+    }
+
+private:
+    static constexpr int magic = 0x4252504b; // "KPRB"
+    static constexpr int version = 1;
+    static constexpr size_t headerSize = 20;
+
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> map;
+    juce::StringArray parameterIDs, names;
+    juce::HashMap<juce::String, int> nameIndex;
+    int numPresets = 0, numParameters = 0;
+    size_t recordStart = 0, recordSize = 0;
+    bool unreadable = false;
+
+    static int readInt(const char* data) noexcept
+    {
+        return (int) juce::ByteOrder::littleEndianInt(data);
+    }
+
+    static float readFloat(const char* data) noexcept
+    {
+        auto bits = juce::ByteOrder::littleEndianInt(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Writes to a temporary file and swaps it in, then remaps
+    bool write(const juce::StringArray& ids, const juce::StringArray& recordNames,
+               const std::vector<std::vector<float>>& records)
+    {
+        juce::MemoryOutputStream idTable;
+        for (auto& id : ids)
+            idTable.writeString(id);
+
+        juce::MemoryOutputStream stream;
+        stream.writeInt(magic);
+        stream.writeInt(version);
+        stream.writeInt((int) records.size());
+        stream.writeInt(ids.size());
+        stream.writeInt((int) idTable.getDataSize());
+        stream.write(idTable.getData(), idTable.getDataSize());
+
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            char name[nameSize] = {};
+            recordNames[(int) i].copyToUTF8(name, nameSize); // Already truncated by getStoredName
+            stream.write(name, nameSize);
+
+            for (auto value : records[i])
+                stream.writeFloat(value);
+        }
+
+        // Unmap before replacing the file (required on Windows)
+        map.reset();
+
+        if (! file.getParentDirectory().createDirectory())
+            return false;
+
+        // Keep a bank this version couldn't read rather than replacing it
+        if (unreadable && ! file.moveFileTo(file.getSiblingFile(file.getFileName() + ".bak").getNonexistentSibling()))
+            return false;
+
+        juce::TemporaryFile temporary(file);
+        if (! temporary.getFile().replaceWithData(stream.getData(), stream.getDataSize())
+            || ! temporary.overwriteTargetFileWithTemporary())
+        {
+            open(file);
+            return false;
+        }
+
+        return open(file);
+    }
+};
@@ -0,0 +1,582 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+enum class ReverbMode
+{
+    Classic = 0, // juce::dsp::Reverb (Freeverb: 8 combs + 4 allpasses per channel)
+    Fast,        // 4-line FDN for live use
+    Dense,       // Diffused 16-line FDN for bounces
+    Convolution  // Partitioned FFT convolution with an impulse response loaded from disk
+};
+
+// Schroeder allpass used to smear transients before they enter the dense FDN
+class AllpassDiffuser
+{
+public:
+    void prepare(double sampleRate, float delayMs)
+    {
+        buffer.assign((size_t) juce::jmax(1, (int) (delayMs * 0.001 * sampleRate)), 0.0f);
+        index = 0;
+    }
+
+    void reset() { std::fill(buffer.begin(), buffer.end(), 0.0f); }
+
+    float processSample(float input) noexcept
+    {
+        auto delayed = buffer[(size_t) index];
+        auto output = delayed - gain * input;
+        buffer[(size_t) index] = input + gain * output;
+        if (++index == (int) buffer.size())
+            index = 0;
+        return output;
+    }
+
+private:
+    static constexpr float gain = 0.6f;
+    std::vector<float> buffer;
+    int index = 0;
+};
+
+// Feedback delay network with a Hadamard mixing matrix and a one-pole damping
+// filter in every feedback path. Delay lengths are fixed at prepare time;
+// room size only changes the per-line feedback gains so it can be swept
+// without zipper noise from moving read heads.
+template <int NumLines>
+class FeedbackDelayNetwork
+{
+public:
+    static_assert((NumLines & (NumLines - 1)) == 0, "Hadamard mixing needs a power-of-two line count");
+
+    void prepare(double newSampleRate)
+    {
+        // Mutually prime-ish lengths between 30 and 100ms; smaller networks take an even spread
+        static constexpr float delayTimesMs[] = { 29.7f, 37.1f, 41.1f, 43.7f, 47.9f, 53.3f, 59.9f, 61.7f,
+                                                  67.1f, 71.3f, 73.9f, 79.7f, 83.1f, 89.3f, 97.1f, 101.9f };
+        static_assert(NumLines <= (int) std::size(delayTimesMs), "Not enough delay times for this network");
+
+        sampleRate = newSampleRate;
+
+        for (int line = 0; line < NumLines; ++line)
+        {
+            auto ms = delayTimesMs[line * (int) std::size(delayTimesMs) / NumLines];
+            lengths[(size_t) line] = juce::jmax(1, (int) (ms * 0.001 * sampleRate)) | 1;
+            buffers[(size_t) line].assign((size_t) lengths[(size_t) line], 0.0f);
+        }
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& buffer : buffers)
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+        indices.fill(0);
+        dampingState.fill(0.0f);
+    }
+
+    // Called at control rate, never per sample
+    void setDecay(float roomSize, float damping)
+    {
+        // Room size 0..1 maps exponentially onto a 0.25s..10s RT60
+        auto rt60 = 0.25 * std::pow(40.0, (double) roomSize);
+
+        for (int line = 0; line < NumLines; ++line)
+            feedbackGains[(size_t) line] = (float) std::pow(10.0, -3.0 * lengths[(size_t) line] / (rt60 * sampleRate));
+
+        dampingCoefficient = damping * 0.7f;
+    }
+
+    void processSample(float input, float& left, float& right) noexcept
+    {
+        std::array<float, NumLines> taps;
+
+        for (size_t line = 0; line < (size_t) NumLines; ++line)
+            taps[line] = buffers[line][(size_t) indices[line]];
+
+        left = 0.0f;
+        right = 0.0f;
+
+        for (size_t line = 0; line < (size_t) NumLines; line += 2)
+        {
+            left += taps[line];
+            right += taps[line + 1];
+        }
+
+        for (size_t line = 0; line < (size_t) NumLines; ++line)
+        {
+            dampingState[line] = taps[line] + dampingCoefficient * (dampingState[line] - taps[line]);
+            taps[line] = dampingState[line] * feedbackGains[line];
+        }
+
+        hadamard(taps);
+
+        for (size_t line = 0; line < (size_t) NumLines; ++line)
+        {
+            buffers[line][(size_t) indices[line]] = input + taps[line];
+            if (++indices[line] == lengths[line])
+                indices[line] = 0;
+        }
+
+        left *= outputScale;
+        right *= outputScale;
+    }
+
+private:
+    static constexpr float outputScale = 2.0f / NumLines;
+
+    double sampleRate = 44100.0;
+    std::array<std::vector<float>, NumLines> buffers;
+    std::array<int, NumLines> lengths {};
+    std::array<int, NumLines> indices {};
+    std::array<float, NumLines> feedbackGains {};
+    std::array<float, NumLines> dampingState {};
+    float dampingCoefficient = 0.0f;
+
+    // In-place fast Walsh-Hadamard transform, normalised so the matrix is orthogonal
+    static void hadamard(std::array<float, NumLines>& values) noexcept
+    {
+        for (size_t span = 1; span < (size_t) NumLines; span <<= 1)
+        {
+            for (size_t start = 0; start < (size_t) NumLines; start += span << 1)
+            {
+                for (size_t i = start; i < start + span; ++i)
+                {
+                    auto a = values[i];
+                    auto b = values[i + span];
+                    values[i] = a + b;
+                    values[i + span] = a - b;
+                }
+            }
+        }
+
+        auto normalise = 1.0f / std::sqrt((float) NumLines);
+        for (auto& value : values)
+            value *= normalise;
+    }
+};
+
+// Pluggable reverb stage for the workstation chain. All modes render a pure
+// wet signal into a scratch buffer and share one smoothed wet/dry mix, so
+// switching mode or automating levels never calls setParameters per block.
+// When the wet level has settled at zero the engines are skipped entirely.
+//
+// The delay networks have no input attenuation of their own, so prepare()
+// measures the impulse-response RMS of Classic, Fast and Dense at a few room
+// sizes and scales the networks' input to match Classic. Convolution gets its
+// own output gain from the same measurement rather than the Freeverb-style
+// wet scaling on top of its normalised impulse response. A mode change
+// crossfades from the outgoing engine's tail instead of cutting it off.
+class ReverbEngine
+{
+public:
+    struct Parameters
+    {
+        float roomSize = 0.3f;
+        float damping = 0.5f;
+        float wetLevel = 0.2f;
+        float dryLevel = 0.8f;
+        ReverbMode mode = ReverbMode::Classic;
+
+        bool operator==(const Parameters& other) const
+        {
+            return roomSize == other.roomSize && damping == other.damping && wetLevel == other.wetLevel
+                && dryLevel == other.dryLevel && mode == other.mode;
+        }
+    };
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        classic.prepare(spec);
+        classic.setParameters(makeClassicParameters(parameters.roomSize, parameters.damping));
+        convolution.prepare(spec);
+        fast.prepare(spec.sampleRate);
+        dense.prepare(spec.sampleRate);
+
+        for (size_t i = 0; i < diffusers.size(); ++i)
+            diffusers[i].prepare(spec.sampleRate, diffuserTimesMs[i]);
+
+        wetBuffer.setSize(2, juce::jmax(1, (int) spec.maximumBlockSize));
+        fadeBuffer.setSize(2, wetBuffer.getNumSamples());
+        crossfadeSamples = juce::jmax(1, (int) (modeCrossfadeSeconds * spec.sampleRate));
+
+        calibrateLevels(spec.sampleRate);
+
+        wetLevel.reset(spec.sampleRate, levelSmoothingSeconds);
+        dryLevel.reset(spec.sampleRate, levelSmoothingSeconds);
+        roomSize.reset(spec.sampleRate, decaySmoothingSeconds);
+        damping.reset(spec.sampleRate, decaySmoothingSeconds);
+
+        wetLevel.setCurrentAndTargetValue(parameters.wetLevel);
+        dryLevel.setCurrentAndTargetValue(parameters.dryLevel);
+        roomSize.setCurrentAndTargetValue(parameters.roomSize);
+        damping.setCurrentAndTargetValue(parameters.damping);
+
+        applyDecay(parameters.roomSize, parameters.damping);
+        reset();
+    }
+
+    void reset()
+    {
+        classic.reset();
+        convolution.reset();
+        fast.reset();
+        dense.reset();
+        for (auto& diffuser : diffusers)
+            diffuser.reset();
+        bypassed = false;
+        fadeSamplesRemaining = 0;
+    }
+
+    // Safe to call from the message thread: juce::dsp::Convolution reads,
+    // resamples and partitions the file on its own background thread and
+    // swaps the new engine in on the audio thread once it is ready.
+    void loadImpulseResponse(const juce::File& file)
+    {
+        convolution.loadImpulseResponse(file,
+                                        juce::dsp::Convolution::Stereo::yes,
+                                        juce::dsp::Convolution::Trim::yes,
+                                        0, // Keep the whole tail
+                                        juce::dsp::Convolution::Normalise::yes);
+    }
+
+    // Cheap to call every block: only retargets smoothers when something moved
+    void setParameters(const Parameters& newParameters)
+    {
+        if (newParameters == parameters)
+            return;
+
+        if (newParameters.mode != parameters.mode)
+            startModeCrossfade(parameters.mode, newParameters.mode);
+
+        parameters = newParameters;
+        wetLevel.setTargetValue(parameters.wetLevel);
+        dryLevel.setTargetValue(parameters.dryLevel);
+        roomSize.setTargetValue(parameters.roomSize);
+        damping.setTargetValue(parameters.damping);
+
+        // Freeverb smooths its own damping/feedback, so it only needs the new targets
+        classic.setParameters(makeClassicParameters(parameters.roomSize, parameters.damping));
+    }
+
+    ReverbMode getMode() const { return parameters.mode; }
+
+    void process(const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        auto& block = context.getOutputBlock();
+        auto numChannels = (int) block.getNumChannels();
+        auto numSamples = (int) block.getNumSamples();
+
+        if (numChannels == 0 || numSamples == 0)
+            return;
+
+        // True bypass: wet has settled at zero, so only the dry gain remains
+        if (wetLevel.getTargetValue() == 0.0f && ! wetLevel.isSmoothing())
+        {
+            bypassed = true;
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                auto gain = dryLevel.getNextValue() * dryScaleFactor;
+                for (int channel = 0; channel < numChannels; ++channel)
+                    block.getChannelPointer((size_t) channel)[sample] *= gain;
+            }
+            return;
+        }
+
+        // Coming out of bypass: the engines still hold a stale tail
+        if (bypassed)
+        {
+            resetMode(parameters.mode);
+            bypassed = false;
+            fadeSamplesRemaining = 0;
+        }
+
+        for (int offset = 0; offset < numSamples; offset += wetBuffer.getNumSamples())
+        {
+            auto chunk = juce::jmin(wetBuffer.getNumSamples(), numSamples - offset);
+            auto* left = block.getChannelPointer(0) + offset;
+            auto* right = block.getChannelPointer(numChannels > 1 ? 1 : 0) + offset;
+
+            renderWet(left, right, chunk);
+
+            auto* wetLeft = wetBuffer.getReadPointer(0);
+            auto* wetRight = wetBuffer.getReadPointer(1);
+
+            for (int sample = 0; sample < chunk; ++sample)
+            {
+                auto wet = wetLevel.getNextValue() * wetScaleFactor;
+                auto dry = dryLevel.getNextValue() * dryScaleFactor;
+
+                left[sample] = left[sample] * dry + wetLeft[sample] * wet;
+                if (numChannels > 1)
+                    right[sample] = right[sample] * dry + wetRight[sample] * wet;
+            }
+        }
+    }
+
+private:
+    // Same scaling as juce::Reverb; Classic runs at unity wet inside it
+    static constexpr float wetScaleFactor = 3.0f;
+    static constexpr float dryScaleFactor = 2.0f;
+    static constexpr double levelSmoothingSeconds = 0.05;
+    static constexpr double decaySmoothingSeconds = 0.1;
+    static constexpr int controlBlockSize = 32;
+    static constexpr double modeCrossfadeSeconds = 0.05;
+
+    // Level matching: impulse responses measured over this long at evenly spaced room sizes
+    static constexpr int numCalibrationSizes = 5;
+    static constexpr double calibrationSeconds = 1.0;
+    static constexpr float calibrationDamping = 0.5f;
+    static constexpr float diffuserTimesMs[] = { 4.7f, 3.6f, 12.7f, 9.3f };
+
+    // Norm (root of the summed squares) juce::dsp::Convolution normalises each impulse response to
+    static constexpr float normalisedImpulseNorm = 0.125f;
+
+    Parameters parameters;
+    juce::SmoothedValue<float> wetLevel, dryLevel;
+    juce::SmoothedValue<float> roomSize, damping;
+
+    static constexpr int convolutionHeadSize = 512;
+
+    juce::dsp::Reverb classic;
+    // Non-uniform partitioning: a short zero-latency head plus larger FFT
+    // partitions for the tail, so 3-6 second IRs stay cheap at small buffers
+    juce::dsp::Convolution convolution { juce::dsp::Convolution::NonUniform { convolutionHeadSize } };
+    FeedbackDelayNetwork<4> fast;
+    FeedbackDelayNetwork<16> dense;
+    std::array<AllpassDiffuser, 4> diffusers;
+
+    juce::AudioBuffer<float> wetBuffer, fadeBuffer;
+    bool bypassed = false;
+
+    // Input gains that bring Fast and Dense to Classic's level, per calibrated room size
+    std::array<float, numCalibrationSizes> fastLevels {}, denseLevels {};
+    float convolutionLevel = 1.0f;  // Normalised impulse response up to Classic's mid-size level
+
+    // The outgoing mode keeps rendering until its fade has run out
+    ReverbMode fadingMode = ReverbMode::Classic;
+    int crossfadeSamples = 1;
+    int fadeSamplesRemaining = 0;
+
+    static juce::dsp::Reverb::Parameters makeClassicParameters(float newRoomSize, float newDamping)
+    {
+        // Unity wet output, no dry: the engine mixes dry/wet itself
+        juce::dsp::Reverb::Parameters classicParameters;
+        classicParameters.roomSize = newRoomSize;
+        classicParameters.damping = newDamping;
+        classicParameters.wetLevel = 1.0f / wetScaleFactor;
+        classicParameters.dryLevel = 0.0f;
+        classicParameters.width = 1.0f;      // Full stereo width
+        classicParameters.freezeMode = 0.0f; // No freeze mode
+        return classicParameters;
+    }
+
+    void applyDecay(float newRoomSize, float newDamping)
+    {
+        fast.setDecay(newRoomSize, newDamping);
+        dense.setDecay(newRoomSize, newDamping);
+    }
+
+    void resetMode(ReverbMode mode)
+    {
+        switch (mode)
+        {
+            case ReverbMode::Classic: classic.reset(); break;
+            case ReverbMode::Convolution: convolution.reset(); break;
+            case ReverbMode::Fast:    fast.reset(); break;
+            case ReverbMode::Dense:
+                dense.reset();
+                for (auto& diffuser : diffusers)
+                    diffuser.reset();
+                break;
+        }
+    }
+
+    void startModeCrossfade(ReverbMode from, ReverbMode to)
+    {
+        // Nothing is audible while bypassed, and leaving bypass resets the engine anyway
+        if (bypassed)
+            return;
+
+        // Switching straight back: the outgoing engine still holds its tail, so just reverse the fade
+        if (fadeSamplesRemaining > 0 && to == fadingMode)
+        {
+            fadingMode = from;
+            fadeSamplesRemaining = crossfadeSamples - fadeSamplesRemaining;
+            return;
+        }
+
+        resetMode(to);
+        fadingMode = from;
+        fadeSamplesRemaining = crossfadeSamples;
+    }
+
+    void renderWet(const float* left, const float* right, int numSamples)
+    {
+        auto* wetLeft = wetBuffer.getWritePointer(0);
+        auto* wetRight = wetBuffer.getWritePointer(1);
+
+        // The outgoing network keeps the decay it had; only the incoming mode advances the smoothers
+        if (fadeSamplesRemaining > 0)
+            renderMode(fadingMode, left, right, fadeBuffer.getWritePointer(0), fadeBuffer.getWritePointer(1), numSamples, false);
+
+        renderMode(parameters.mode, left, right, wetLeft, wetRight, numSamples, true);
+
+        if (fadeSamplesRemaining <= 0)
+            return;
+
+        // Equal-power: the two engines' tails are uncorrelated
+        auto* fadeLeft = fadeBuffer.getReadPointer(0);
+        auto* fadeRight = fadeBuffer.getReadPointer(1);
+
+        for (int sample = 0; sample < numSamples && fadeSamplesRemaining > 0; ++sample, --fadeSamplesRemaining)
+        {
+            auto outgoing = (float) fadeSamplesRemaining / (float) crossfadeSamples;
+            auto outGain = std::sqrt(outgoing);
+            auto inGain = std::sqrt(1.0f - outgoing);
+
+            wetLeft[sample] = wetLeft[sample] * inGain + fadeLeft[sample] * outGain;
+            wetRight[sample] = wetRight[sample] * inGain + fadeRight[sample] * outGain;
+        }
+    }
+
+    void renderMode(ReverbMode mode, const float* left, const float* right,
+                    float* wetLeft, float* wetRight, int numSamples, bool advanceDecay)
+    {
+        if (mode == ReverbMode::Classic || mode == ReverbMode::Convolution)
+        {
+            // Until an impulse response has loaded the convolver is a pass-through
+            if (mode == ReverbMode::Convolution && convolution.getCurrentIRSize() == 0)
+            {
+                juce::FloatVectorOperations::clear(wetLeft, numSamples);
+                juce::FloatVectorOperations::clear(wetRight, numSamples);
+                return;
+            }
+
+            juce::FloatVectorOperations::copy(wetLeft, left, numSamples);
+            juce::FloatVectorOperations::copy(wetRight, right, numSamples);
+
+            float* channels[] = { wetLeft, wetRight };
+            juce::dsp::AudioBlock<float> wetBlock(channels, 2, (size_t) numSamples);
+            juce::dsp::ProcessContextReplacing<float> wetContext(wetBlock);
+
+            if (mode == ReverbMode::Classic)
+            {
+                classic.process(wetContext);
+            }
+            else
+            {
+                convolution.process(wetContext);
+                wetBlock.multiplyBy(convolutionLevel);
+            }
+            return;
+        }
+
+        for (int offset = 0; offset < numSamples; offset += controlBlockSize)
+        {
+            auto count = juce::jmin(controlBlockSize, numSamples - offset);
+
+            if (advanceDecay && (roomSize.isSmoothing() || damping.isSmoothing()))
+                applyDecay(roomSize.skip(count), damping.skip(count));
+
+            auto level = getLevelMatch(mode == ReverbMode::Dense ? denseLevels : fastLevels, roomSize.getCurrentValue());
+
+            for (int sample = offset; sample < offset + count; ++sample)
+            {
+                auto input = 0.5f * (left[sample] + right[sample]) * level;
+
+                if (mode == ReverbMode::Dense)
+                {
+                    for (auto& diffuser : diffusers)
+                        input = diffuser.processSample(input);
+
+                    dense.processSample(input, wetLeft[sample], wetRight[sample]);
+                }
+                else
+                {
+                    fast.processSample(input, wetLeft[sample], wetRight[sample]);
+                }
+            }
+        }
+    }
+
+    static float getLevelMatch(const std::array<float, numCalibrationSizes>& levels, float size) noexcept
+    {
+        auto position = juce::jlimit(0.0f, 1.0f, size) * (float) (numCalibrationSizes - 1);
+        auto index = juce::jmin((int) position, numCalibrationSizes - 2);
+        auto fraction = position - (float) index;
+        return levels[(size_t) index] + fraction * (levels[(size_t) index + 1] - levels[(size_t) index]);
+    }
+
+    // Message thread, from prepare(): renders an impulse through fresh copies of each engine
+    void calibrateLevels(double sampleRate)
+    {
+        auto length = juce::jmax(1, (int) (calibrationSeconds * sampleRate));
+
+        for (int i = 0; i < numCalibrationSizes; ++i)
+        {
+            auto size = (float) i / (float) (numCalibrationSizes - 1);
+            auto reference = measureClassic(sampleRate, size, length);
+
+            fastLevels[(size_t) i] = matchLevel(reference, measureNetwork<4>(sampleRate, size, length, false));
+            denseLevels[(size_t) i] = matchLevel(reference, measureNetwork<16>(sampleRate, size, length, true));
+
+            // A convolution has no room size, so it matches Classic's middle setting
+            if (i == numCalibrationSizes / 2)
+                convolutionLevel = matchLevel(reference * std::sqrt((float) length), normalisedImpulseNorm);
+        }
+    }
+
+    static float matchLevel(float reference, float measured) noexcept
+    {
+        return measured > 1.0e-9f ? reference / measured : 1.0f;
+    }
+
+    static float measureClassic(double sampleRate, float size, int length)
+    {
+        // setSampleRate snaps Freeverb's smoothers onto the parameters set before it
+        juce::Reverb impulseReverb;
+        impulseReverb.setParameters(makeClassicParameters(size, calibrationDamping));
+        impulseReverb.setSampleRate(sampleRate);
+
+        std::vector<float> impulseLeft((size_t) length, 0.0f), impulseRight((size_t) length, 0.0f);
+        impulseLeft[0] = impulseRight[0] = 1.0f;
+        impulseReverb.processStereo(impulseLeft.data(), impulseRight.data(), length);
+
+        double energy = 0.0;
+        for (size_t sample = 0; sample < (size_t) length; ++sample)
+            energy += impulseLeft[sample] * impulseLeft[sample] + impulseRight[sample] * impulseRight[sample];
+
+        return (float) std::sqrt(energy / (2.0 * length));
+    }
+
+    template <int NumLines>
+    static float measureNetwork(double sampleRate, float size, int length, bool diffused)
+    {
+        FeedbackDelayNetwork<NumLines> network;
+        network.prepare(sampleRate);
+        network.setDecay(size, calibrationDamping);
+
+        std::array<AllpassDiffuser, 4> impulseDiffusers;
+        for (size_t i = 0; i < impulseDiffusers.size(); ++i)
+            impulseDiffusers[i].prepare(sampleRate, diffuserTimesMs[i]);
+
+        double energy = 0.0;
+        for (int sample = 0; sample < length; ++sample)
+        {
+            auto input = sample == 0 ? 1.0f : 0.0f;
+
+            if (diffused)
+                for (auto& diffuser : impulseDiffusers)
+                    input = diffuser.processSample(input);
+
+            float wetLeft, wetRight;
+            network.processSample(input, wetLeft, wetRight);
+            energy += wetLeft * wetLeft + wetRight * wetRight;
+        }
+
+        return (float) std::sqrt(energy / (2.0 * length));
+    }
+};
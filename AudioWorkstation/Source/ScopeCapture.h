@@ -0,0 +1,187 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+
+// Oscilloscope capture, run on the audio thread. A rising zero crossing arms
+// each sweep so the waveform sits still on screen; in pitch-locked mode the
+// sweep length is also snapped to a whole number of periods. Samples are
+// reduced to min/max per display column as they arrive, so the editor only
+// ever touches numColumns values, however many samples the sweep spans.
+// Finished sweeps are handed over through a lock-free triple buffer.
+class ScopeCapture
+{
+public:
+    enum class TriggerMode
+    {
+        ZeroCrossing = 0,
+        PitchLocked
+    };
+
+    static constexpr int numColumns = 1024;
+    static constexpr int sweepSamples = 2048; // Target sweep length (~46ms at 44.1kHz)
+
+    struct Frame
+    {
+        std::array<float, numColumns> minimum {}, maximum {};
+        int numColumnsUsed = 0;
+        bool triggered = false;      // False when auto mode free-ran without finding a crossing
+        float periodSamples = 0.0f;  // Tracked pitch period, 0 when unknown
+    };
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset()
+    {
+        capturing = false;
+        armedBelowZero = false;
+        samplesSinceCrossing = 0;
+        samplesWaiting = 0;
+        periodSamples = 0.0f;
+        previousSample = 0.0f;
+    }
+
+    void setTriggerMode(TriggerMode newMode) { triggerMode = newMode; }
+    TriggerMode getTriggerMode() const { return triggerMode.load(); }
+
+    // Audio thread. Right may be null for mono; stereo is captured as mid (L+R)/2.
+    void pushSamples(const float* left, const float* right, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto sample = right != nullptr ? 0.5f * (left[i] + right[i]) : left[i];
+            bool crossing = detectRisingCrossing(sample);
+
+            if (capturing)
+            {
+                addToSweep(sample);
+            }
+            else if (crossing || ++samplesWaiting > autoTriggerSamples())
+            {
+                startSweep(crossing);
+                addToSweep(sample);
+            }
+
+            previousSample = sample;
+        }
+    }
+
+    // Message thread. Returns true and fills dest when a new sweep has finished since the last call.
+    bool readFrame(Frame& dest) noexcept
+    {
+        if ((latest.load(std::memory_order_acquire) & newDataFlag) == 0)
+            return false;
+
+        frontIndex = latest.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+        dest = frames[(size_t) frontIndex];
+        return true;
+    }
+
+private:
+    static constexpr float hysteresis = 0.002f; // Ignore crossings in the noise floor
+    static constexpr int newDataFlag = 4;
+    static constexpr int indexMask = 3;
+
+    double sampleRate = 44100.0;
+    std::atomic<TriggerMode> triggerMode { TriggerMode::PitchLocked };
+
+    // Trigger and pitch tracking
+    bool armedBelowZero = false;
+    float previousSample = 0.0f;
+    int samplesSinceCrossing = 0;
+    int samplesWaiting = 0;
+    float periodSamples = 0.0f;
+
+    // Sweep in progress
+    bool capturing = false;
+    int sweepLength = sweepSamples;
+    int sweepPosition = 0;
+    int columnsUsed = numColumns;
+    int currentColumn = -1;
+
+    // Triple buffer: the audio thread owns backIndex, the editor owns frontIndex,
+    // and latest holds the third slot plus a flag saying it's unread
+    std::array<Frame, 3> frames;
+    int backIndex = 0, frontIndex = 1;
+    std::atomic<int> latest { 2 };
+
+    int autoTriggerSamples() const noexcept
+    {
+        return sweepSamples * 2 + (int) (sampleRate / 20.0);
+    }
+
+    bool detectRisingCrossing(float sample) noexcept
+    {
+        ++samplesSinceCrossing;
+
+        if (sample < -hysteresis)
+            armedBelowZero = true;
+
+        if (! (armedBelowZero && previousSample < 0.0f && sample >= 0.0f))
+            return false;
+
+        armedBelowZero = false;
+
+        // Crossing intervals between 20Hz and 5kHz feed the smoothed period estimate
+        auto interval = (float) samplesSinceCrossing;
+        samplesSinceCrossing = 0;
+
+        if (interval >= (float) (sampleRate / 5000.0) && interval <= (float) (sampleRate / 20.0))
+            periodSamples = periodSamples > 0.0f && std::abs(interval - periodSamples) < periodSamples * 0.25f
+                          ? periodSamples * 0.8f + interval * 0.2f
+                          : interval;
+
+        return true;
+    }
+
+    void startSweep(bool triggered) noexcept
+    {
+        sweepLength = sweepSamples;
+
+        // A whole number of periods makes consecutive sweeps identical for periodic signals
+        if (triggered && triggerMode.load() == TriggerMode::PitchLocked && periodSamples > 0.0f)
+        {
+            auto periods = juce::jmax(1.0f, std::round((float) sweepSamples / periodSamples));
+            sweepLength = juce::jmax(1, juce::roundToInt(periods * periodSamples));
+        }
+
+        auto& frame = frames[(size_t) backIndex];
+        frame.triggered = triggered;
+        frame.periodSamples = periodSamples;
+
+        columnsUsed = juce::jmin(numColumns, sweepLength);
+        sweepPosition = 0;
+        currentColumn = -1;
+        samplesWaiting = 0;
+        capturing = true;
+    }
+
+    void addToSweep(float sample) noexcept
+    {
+        auto& frame = frames[(size_t) backIndex];
+        auto column = (int) ((juce::int64) sweepPosition * columnsUsed / sweepLength);
+
+        if (column != currentColumn)
+        {
+            currentColumn = column;
+            frame.minimum[(size_t) column] = sample;
+            frame.maximum[(size_t) column] = sample;
+        }
+        else
+        {
+            frame.minimum[(size_t) column] = juce::jmin(frame.minimum[(size_t) column], sample);
+            frame.maximum[(size_t) column] = juce::jmax(frame.maximum[(size_t) column], sample);
+        }
+
+        if (++sweepPosition >= sweepLength)
+        {
+            frame.numColumnsUsed = columnsUsed;
+            capturing = false;
+            backIndex = latest.exchange(backIndex | newDataFlag, std::memory_order_acq_rel) & indexMask;
+        }
+    }
+};
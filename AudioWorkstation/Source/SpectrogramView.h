@@ -0,0 +1,150 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Scrolling spectrogram (waterfall) backed by a ring-buffer image. Each analysis
+// frame writes one column of pixels straight into the bitmap; drawing is two
+// blits either side of the write position, so nothing is ever shifted or redrawn.
+// Rows run log-frequency from 30Hz at the bottom to Nyquist at the top, on the
+// scale set by setAnalysisScale() (the processor's sample rate and FFT size).
+class SpectrogramView
+{
+public:
+    static constexpr int defaultColumns = 512;  // ~11s of history at 1024-point frames
+    static constexpr int defaultRows = 2048;
+
+    SpectrogramView()
+    {
+        setSize(defaultColumns, defaultRows);
+        setColours(0.0f, 0.5f);
+    }
+
+    void setSize(int newColumns, int newRows)
+    {
+        numColumns = juce::jmax(2, newColumns);
+        numRows = juce::jmax(2, newRows);
+
+        // Software image so BitmapData points at real memory instead of mapping a GPU texture
+        image = juce::Image(juce::Image::ARGB, numColumns, numRows, true, juce::SoftwareImageType());
+        writeColumn = 0;
+        silentColumns = numColumns;
+
+        // Fractional FFT bin for each row
+        auto binWidth = (float) (sampleRate / fftSize);
+        rowBins.resize((size_t) numRows);
+        for (int row = 0; row < numRows; ++row)
+        {
+            auto proportion = 1.0f - (float) row / (float) (numRows - 1);
+            auto freq = juce::mapToLog10(proportion, 30.0f, getNyquist());
+            rowBins[(size_t) row] = freq / binWidth;
+        }
+    }
+
+    // Frames of fftSize points taken at sampleRate. A change clears the history,
+    // which was drawn on the old scale; returns true when that happened.
+    bool setAnalysisScale(double newSampleRate, int newFftSize)
+    {
+        if (newSampleRate <= 0.0 || newFftSize <= 0 || (newSampleRate == sampleRate && newFftSize == fftSize))
+            return false;
+
+        sampleRate = newSampleRate;
+        fftSize = newFftSize;
+        setSize(numColumns, numRows);
+        return true;
+    }
+
+    float getNyquist() const noexcept { return (float) (sampleRate * 0.5); }
+
+    // Intensity palette: black through the two visualizer hues to white
+    void setColours(float hue1, float hue2)
+    {
+        for (int i = 0; i < paletteSize; ++i)
+        {
+            auto level = (float) i / (float) (paletteSize - 1);
+            juce::Colour colour;
+
+            if (level < 0.5f)
+                colour = juce::Colour::fromHSV(hue1, 0.9f, level * 2.0f, 1.0f);
+            else
+                colour = juce::Colour::fromHSV(hue1 + (hue2 - hue1) * (level - 0.5f) * 2.0f,
+                                               0.9f - (level - 0.5f) * 1.2f, 1.0f, 1.0f);
+
+            palette[(size_t) i] = colour.getPixelARGB();
+        }
+    }
+
+    // Writes one column from FFT magnitudes and advances the ring
+    void pushColumn(const std::vector<float>& magnitudes)
+    {
+        if (magnitudes.empty())
+            return;
+
+        juce::Image::BitmapData pixels(image, writeColumn, 0, 1, numRows, juce::Image::BitmapData::writeOnly);
+        auto lastBin = (float) (magnitudes.size() - 1);
+        bool silent = true;
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            auto bin = juce::jmin(rowBins[(size_t) row], lastBin);
+            auto index = (size_t) bin;
+            auto fraction = bin - (float) index;
+            auto next = juce::jmin(index + 1, magnitudes.size() - 1);
+            auto magnitude = magnitudes[index] + fraction * (magnitudes[next] - magnitudes[index]);
+
+            // Same scaling as the bars; the square root lifts quiet partials into view
+            auto level = std::sqrt(juce::jlimit(0.0f, 1.0f, magnitude * 2000.0f));
+            auto paletteIndex = (int) (level * (float) (paletteSize - 1));
+            silent = silent && paletteIndex == 0;
+
+            *reinterpret_cast<juce::PixelARGB*>(pixels.getLinePointer(row)) = palette[(size_t) paletteIndex];
+        }
+
+        silentColumns = silent ? juce::jmin(silentColumns + 1, numColumns) : 0;
+        writeColumn = (writeColumn + 1) % numColumns;
+    }
+
+    // True once every column in the ring is black, so there's nothing left to scroll
+    bool isBlank() const noexcept
+    {
+        return silentColumns >= numColumns;
+    }
+
+    int getNumColumns() const noexcept
+    {
+        return numColumns;
+    }
+
+    // Oldest columns on the left: [writeColumn, end) then [0, writeColumn)
+    void draw(juce::Graphics& g, juce::Rectangle<int> area) const
+    {
+        g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+
+        auto olderColumns = numColumns - writeColumn;
+        auto splitX = area.getX() + juce::roundToInt((float) area.getWidth() * (float) olderColumns / (float) numColumns);
+
+        g.drawImage(image, area.getX(), area.getY(), splitX - area.getX(), area.getHeight(),
+                    writeColumn, 0, olderColumns, numRows);
+
+        if (writeColumn > 0)
+            g.drawImage(image, splitX, area.getY(), area.getRight() - splitX, area.getHeight(),
+                        0, 0, writeColumn, numRows);
+    }
+
+    // Vertical position of a frequency in the drawn area, for grid labels
+    float getYForFrequency(float freq, juce::Rectangle<float> area) const
+    {
+        return area.getBottom() - juce::mapFromLog10(freq, 30.0f, getNyquist()) * area.getHeight();
+    }
+
+private:
+    static constexpr int paletteSize = 256;
+
+    juce::Image image;
+    int numColumns = 0, numRows = 0;
+    double sampleRate = 44100.0;
+    int fftSize = 1024;
+    int writeColumn = 0;
+    int silentColumns = 0;
+
+    std::vector<float> rowBins;
+    std::array<juce::PixelARGB, paletteSize> palette;
+};
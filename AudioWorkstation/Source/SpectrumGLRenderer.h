@@ -0,0 +1,238 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_opengl/juce_opengl.h>
+
+// Batched OpenGL renderer for the spectrum display. The owning component builds
+// one triangle list per frame on the message thread; the GL thread uploads it
+// into a single vertex buffer and draws the whole frame with one call. The
+// shaders only need GLSL 1.10 / GLES 2, so this also runs on Mesa's llvmpipe
+// (LIBGL_ALWAYS_SOFTWARE=1) on headless Linux.
+//
+// Component painting stays enabled, so anything the component paints (grid,
+// labels, branding) is composited on top of the GL layer.
+class SpectrumGLRenderer : public juce::OpenGLRenderer
+{
+public:
+    struct Vertex
+    {
+        float x, y;
+        float r, g, b, a;
+    };
+
+    using Vertices = std::vector<Vertex>;
+
+    explicit SpectrumGLRenderer(juce::Component& targetComponent) : target(targetComponent) {}
+
+    ~SpectrumGLRenderer() override
+    {
+        detach();
+    }
+
+    void attach()
+    {
+        failed = false;
+        context.setRenderer(this);
+        context.setComponentPaintingEnabled(true);
+        context.setContinuousRepainting(false);
+        context.attachTo(target);
+    }
+
+    void detach()
+    {
+        context.detach();
+    }
+
+    // True while the GL layer is drawing the spectrum; false means the owner paints it
+    bool isActive() const
+    {
+        return context.isAttached() && ! failed;
+    }
+
+    // Called on the message thread with the compiler's error if the context can't compile the shaders
+    std::function<void(const juce::String&)> onFailure;
+
+    // Hands over a finished frame. The vectors are swapped, not copied, so the
+    // caller gets the previous frame's storage back to refill next time.
+    void setVertices(Vertices& newVertices, float width, float height)
+    {
+        const juce::SpinLock::ScopedLockType lock(vertexLock);
+        pendingVertices.swap(newVertices);
+        pendingWidth = width;
+        pendingHeight = height;
+        hasPendingVertices = true;
+    }
+
+    //==============================================================================
+    // Thick lines and rectangles as two triangles each, so line width never depends
+    // on glLineWidth (which core profiles and llvmpipe clamp to 1px)
+    static void addLine(Vertices& vertices, float x1, float y1, float x2, float y2,
+                        float thickness, juce::Colour colour)
+    {
+        auto dx = x2 - x1, dy = y2 - y1;
+        auto length = std::sqrt(dx * dx + dy * dy);
+
+        if (length <= 0.0f)
+            return;
+
+        auto nx = -dy / length * thickness * 0.5f;
+        auto ny = dx / length * thickness * 0.5f;
+
+        addQuad(vertices, x1 + nx, y1 + ny, x2 + nx, y2 + ny, x2 - nx, y2 - ny, x1 - nx, y1 - ny, colour);
+    }
+
+    static void addRectangle(Vertices& vertices, juce::Rectangle<float> area, juce::Colour colour)
+    {
+        addQuad(vertices, area.getX(), area.getY(), area.getRight(), area.getY(),
+                area.getRight(), area.getBottom(), area.getX(), area.getBottom(), colour);
+    }
+
+    //==============================================================================
+    void newOpenGLContextCreated() override
+    {
+        using namespace juce::gl;
+
+        shader = std::make_unique<juce::OpenGLShaderProgram>(context);
+
+        const char* vertexShader =
+            "attribute vec2 position;\n"
+            "attribute vec4 colour;\n"
+            "uniform vec2 viewSize;\n"
+            "varying vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColour = colour;\n"
+            "    gl_Position = vec4(position.x / viewSize.x * 2.0 - 1.0, 1.0 - position.y / viewSize.y * 2.0, 0.0, 1.0);\n"
+            "}\n";
+
+        const char* fragmentShader =
+            "varying " JUCE_LOWP " vec4 fragColour;\n"
+            "void main()\n"
+            "{\n"
+            "    gl_FragColor = fragColour;\n"
+            "}\n";
+
+        if (! shader->addVertexShader(juce::OpenGLHelpers::translateVertexShaderToV3(vertexShader))
+            || ! shader->addFragmentShader(juce::OpenGLHelpers::translateFragmentShaderToV3(fragmentShader))
+            || ! shader->link())
+        {
+            auto error = shader->getLastError();
+            shader.reset();
+            failed = true;
+
+            juce::MessageManager::callAsync([safeTarget = juce::Component::SafePointer<juce::Component>(&target), this, error]
+            {
+                if (safeTarget != nullptr && onFailure != nullptr)
+                    onFailure(error);
+            });
+            return;
+        }
+
+        positionAttribute = std::make_unique<juce::OpenGLShaderProgram::Attribute>(*shader, "position");
+        colourAttribute = std::make_unique<juce::OpenGLShaderProgram::Attribute>(*shader, "colour");
+        viewSizeUniform = std::make_unique<juce::OpenGLShaderProgram::Uniform>(*shader, "viewSize");
+
+        glGenBuffers(1, &vertexBuffer);
+    }
+
+    void renderOpenGL() override
+    {
+        using namespace juce::gl;
+
+        juce::OpenGLHelpers::clear(juce::Colours::black);
+
+        if (shader == nullptr)
+            return;
+
+        {
+            // Never block the GL thread on the message thread; a busy lock just
+            // redraws the previous frame
+            const juce::SpinLock::ScopedTryLockType lock(vertexLock);
+
+            if (lock.isLocked() && hasPendingVertices)
+            {
+                vertices.swap(pendingVertices);
+                viewWidth = pendingWidth;
+                viewHeight = pendingHeight;
+                hasPendingVertices = false;
+            }
+        }
+
+        if (vertices.empty() || viewWidth <= 0.0f || viewHeight <= 0.0f)
+            return;
+
+        auto scale = (float) context.getRenderingScale();
+        glViewport(0, 0, juce::roundToInt(scale * viewWidth), juce::roundToInt(scale * viewHeight));
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        shader->use();
+        viewSizeUniform->set(viewWidth, viewHeight);
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (vertices.size() * sizeof(Vertex)), vertices.data(), GL_STREAM_DRAW);
+
+        auto position = (GLuint) positionAttribute->attributeID;
+        auto colour = (GLuint) colourAttribute->attributeID;
+
+        glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+        glEnableVertexAttribArray(position);
+        glVertexAttribPointer(colour, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*) (sizeof(float) * 2));
+        glEnableVertexAttribArray(colour);
+
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei) vertices.size());
+
+        glDisableVertexAttribArray(position);
+        glDisableVertexAttribArray(colour);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void openGLContextClosing() override
+    {
+        using namespace juce::gl;
+
+        if (vertexBuffer != 0)
+            glDeleteBuffers(1, &vertexBuffer);
+
+        vertexBuffer = 0;
+        positionAttribute.reset();
+        colourAttribute.reset();
+        viewSizeUniform.reset();
+        shader.reset();
+    }
+
+private:
+    juce::Component& target;
+    juce::OpenGLContext context;
+
+    std::unique_ptr<juce::OpenGLShaderProgram> shader;
+    std::unique_ptr<juce::OpenGLShaderProgram::Attribute> positionAttribute, colourAttribute;
+    std::unique_ptr<juce::OpenGLShaderProgram::Uniform> viewSizeUniform;
+    juce::gl::GLuint vertexBuffer = 0;
+    std::atomic<bool> failed { false };
+
+    // Message thread -> GL thread handoff
+    juce::SpinLock vertexLock;
+    Vertices pendingVertices;
+    float pendingWidth = 0.0f, pendingHeight = 0.0f;
+    bool hasPendingVertices = false;
+
+    // GL thread only
+    Vertices vertices;
+    float viewWidth = 0.0f, viewHeight = 0.0f;
+
+    static void addQuad(Vertices& vertices, float x1, float y1, float x2, float y2,
+                        float x3, float y3, float x4, float y4, juce::Colour colour)
+    {
+        auto r = colour.getFloatRed(), g = colour.getFloatGreen(), b = colour.getFloatBlue(), a = colour.getFloatAlpha();
+
+        vertices.push_back({ x1, y1, r, g, b, a });
+        vertices.push_back({ x2, y2, r, g, b, a });
+        vertices.push_back({ x3, y3, r, g, b, a });
+        vertices.push_back({ x1, y1, r, g, b, a });
+        vertices.push_back({ x3, y3, r, g, b, a });
+        vertices.push_back({ x4, y4, r, g, b, a });
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumGLRenderer)
+};
@@ -0,0 +1,302 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "PatternLibrary.h"
+
+// Multi-lane step sequencer behind the built-in generator. The melody, chord,
+// bass and percussion lanes each play their own compiled step table on their
+// own MIDI channel, which the synth maps to a reserved voice group, so a bass
+// note can never steal a melody voice.
+//
+// Lanes share one eighth-note clock. Each has its own length, so lanes of
+// different lengths cycle against each other as polymeters, and its own swing,
+// which delays odd steps by up to half a step. A block is one pass that jumps
+// from event to event (clock steps, swung steps, ratchet retriggers) instead of
+// visiting every sample.
+//
+// Tables and settings posted from the message thread are taken under a try-lock
+// on the first step of a bar; if the lock is busy they wait for the next bar.
+class StepSequencer
+{
+public:
+    enum Lane
+    {
+        melodyLane = 0,
+        chordLane,
+        bassLane,
+        percussionLane,
+        numLanes
+    };
+
+    static constexpr int stepsPerBar = 8; // Eighth notes in 4/4
+    static constexpr int maxLaneNotes = 3; // A triad
+
+    static int getLaneChannel(int lane)
+    {
+        // Percussion on the General MIDI drum channel. Lane events only reach the lanes'
+        // own voices, so these never clash with the channels a controller plays on
+        static const int channels[] = { 13, 14, 15, 10 };
+        return channels[juce::jlimit(0, numLanes - 1, lane)];
+    }
+
+    // Names as used in the pattern file's "lanes" object
+    static juce::String getLaneName(int lane)
+    {
+        static const char* const names[] = { "melody", "chords", "bass", "percussion" };
+        return names[juce::jlimit(0, numLanes - 1, lane)];
+    }
+
+    struct LaneSettings
+    {
+        bool enabled = true;
+        int length = 0;      // Steps before the lane repeats; 0 plays the whole table
+        float swing = 0.0f;  // Fraction of a step odd steps are delayed by, 0-0.5
+    };
+
+    // Message thread
+    void postLane(int lane, const PatternLibrary::StepTable& table, const LaneSettings& settings)
+    {
+        const juce::SpinLock::ScopedLockType scopedLock(lock);
+        pending[(size_t) lane] = { table, settings, true };
+    }
+
+    // For an offline sequencer that nothing else is running
+    void setLane(int lane, const PatternLibrary::StepTable& table, const LaneSettings& settings)
+    {
+        lanes[(size_t) lane].table = table;
+        lanes[(size_t) lane].settings = settings;
+    }
+
+    void setRandomSeed(juce::int64 seed) { random.setSeed(seed); }
+
+    bool isRunning() const { return step > 0; }
+
+    // Ends every sounding note at the given sample and rewinds to the first step
+    void stop(juce::MidiBuffer& midi, int sample)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            stopNotes(lane, midi, sample);
+            lanes[(size_t) lane].samplesUntilStep = -1;
+            lanes[(size_t) lane].ratchetsRemaining = 0;
+        }
+
+        step = 0;
+        samplesUntilStep = 0;
+    }
+
+    void process(juce::MidiBuffer& midi, int numSamples, int samplesPerStep, int rootKey)
+    {
+        samplesPerStep = juce::jmax(2, samplesPerStep);
+        auto position = 0;
+
+        for (;;)
+        {
+            // Next event: the clock, an armed (swung) lane step or a ratchet
+            auto untilEvent = samplesUntilStep;
+            for (auto& lane : lanes)
+            {
+                if (lane.samplesUntilStep >= 0)
+                    untilEvent = juce::jmin(untilEvent, lane.samplesUntilStep);
+                if (lane.ratchetsRemaining > 0)
+                    untilEvent = juce::jmin(untilEvent, lane.samplesUntilRatchet);
+            }
+
+            if (position + untilEvent >= numSamples)
+            {
+                advance(numSamples - position);
+                return;
+            }
+
+            advance(untilEvent);
+            position += untilEvent;
+
+            if (samplesUntilStep == 0)
+            {
+                // Edits land on the downbeat so a bar never mixes two tables
+                if (step % stepsPerBar == 0)
+                    takePending();
+
+                // Arm every lane, odd steps later by the lane's swing
+                for (auto& lane : lanes)
+                {
+                    lane.armedStep = step;
+                    lane.samplesUntilStep = (step & 1) != 0 ? juce::jmin(samplesPerStep - 1, juce::roundToInt(lane.settings.swing * (float) samplesPerStep)) : 0;
+                }
+
+                samplesUntilStep = samplesPerStep;
+                ++step;
+            }
+
+            for (int index = 0; index < numLanes; ++index)
+            {
+                auto& lane = lanes[(size_t) index];
+
+                if (lane.samplesUntilStep == 0)
+                {
+                    lane.samplesUntilStep = -1;
+                    playStep(index, midi, position, samplesPerStep, rootKey);
+                }
+                else if (lane.ratchetsRemaining > 0 && lane.samplesUntilRatchet == 0)
+                {
+                    stopNotes(index, midi, position, false);
+                    startNotes(index, midi, position);
+                    lane.samplesUntilRatchet = lane.ratchetInterval;
+                    --lane.ratchetsRemaining;
+                }
+            }
+        }
+    }
+
+private:
+    struct LaneState
+    {
+        PatternLibrary::StepTable table;
+        LaneSettings settings;
+        juce::int64 armedStep = 0;
+        int samplesUntilStep = -1; // Negative when no step is armed
+        std::array<int, maxLaneNotes> notes {};
+        std::array<float, maxLaneNotes> velocities {};
+        int numNotes = 0;
+        int ratchetsRemaining = 0, ratchetInterval = 0, samplesUntilRatchet = 0;
+    };
+
+    struct PendingLane
+    {
+        PatternLibrary::StepTable table;
+        LaneSettings settings;
+        bool waiting = false;
+    };
+
+    std::array<LaneState, numLanes> lanes;
+    juce::int64 step = 0;
+    int samplesUntilStep = 0;
+    juce::Random random;
+
+    juce::SpinLock lock;
+    std::array<PendingLane, numLanes> pending;
+
+    void takePending()
+    {
+        const juce::SpinLock::ScopedTryLockType scopedLock(lock);
+        if (! scopedLock.isLocked())
+            return;
+
+        for (size_t i = 0; i < lanes.size(); ++i)
+        {
+            if (pending[i].waiting)
+            {
+                lanes[i].table = pending[i].table;
+                lanes[i].settings = pending[i].settings;
+                pending[i].waiting = false;
+            }
+        }
+    }
+
+    void advance(int samples)
+    {
+        samplesUntilStep -= samples;
+
+        for (auto& lane : lanes)
+        {
+            if (lane.samplesUntilStep >= 0)
+                lane.samplesUntilStep -= samples;
+            if (lane.ratchetsRemaining > 0)
+                lane.samplesUntilRatchet -= samples;
+        }
+    }
+
+    void playStep(int index, juce::MidiBuffer& midi, int sample, int samplesPerStep, int rootKey)
+    {
+        auto& lane = lanes[(size_t) index];
+        lane.ratchetsRemaining = 0;
+
+        if (! lane.settings.enabled || lane.table.numSteps == 0)
+        {
+            stopNotes(index, midi, sample);
+            return;
+        }
+
+        auto length = lane.settings.length > 0 ? lane.settings.length : lane.table.numSteps;
+        const auto& current = lane.table.steps[(size_t) ((lane.armedStep % length) % lane.table.numSteps)];
+
+        // A tie holds whatever the previous step left sounding
+        if (current.type == PatternLibrary::Step::tie)
+            return;
+
+        stopNotes(index, midi, sample);
+
+        if (current.type != PatternLibrary::Step::note || random.nextFloat() >= current.probability)
+            return;
+
+        auto velocity = current.velocity;
+
+        switch (index)
+        {
+            case melodyLane:
+                addNote(lane, rootKey + current.offset, velocity);
+                if (current.chord)
+                {
+                    addNote(lane, rootKey + current.thirdOffset, velocity * 0.6f);
+                    addNote(lane, rootKey + current.fifthOffset, velocity * 0.5f);
+                }
+                break;
+
+            case chordLane:
+                addNote(lane, rootKey + current.offset, velocity * 0.6f);
+                addNote(lane, rootKey + current.thirdOffset, velocity * 0.6f);
+                addNote(lane, rootKey + current.fifthOffset, velocity * 0.5f);
+                break;
+
+            case bassLane:
+                addNote(lane, rootKey - 12 + current.offset, velocity * 0.6f);
+                break;
+
+            case percussionLane:
+            default:
+            {
+                // General MIDI kick, snare, closed hat, open hat, clap, low tom, high tom, crash
+                static const int kit[] = { 36, 38, 42, 46, 39, 45, 50, 49 };
+                constexpr int kitSize = (int) std::size(kit);
+                addNote(lane, kit[((current.degree % kitSize) + kitSize) % kitSize], velocity);
+                break;
+            }
+        }
+
+        startNotes(index, midi, sample);
+
+        if (current.ratchets > 1)
+        {
+            lane.ratchetsRemaining = current.ratchets - 1;
+            lane.ratchetInterval = juce::jmax(1, samplesPerStep / current.ratchets);
+            lane.samplesUntilRatchet = lane.ratchetInterval;
+        }
+    }
+
+    static void addNote(LaneState& lane, int note, float velocity)
+    {
+        if (note >= 0 && note < 128 && lane.numNotes < maxLaneNotes)
+        {
+            lane.notes[(size_t) lane.numNotes] = note;
+            lane.velocities[(size_t) lane.numNotes] = velocity;
+            ++lane.numNotes;
+        }
+    }
+
+    void startNotes(int index, juce::MidiBuffer& midi, int sample) const
+    {
+        auto& lane = lanes[(size_t) index];
+        for (int i = 0; i < lane.numNotes; ++i)
+            midi.addEvent(juce::MidiMessage::noteOn(getLaneChannel(index), lane.notes[(size_t) i], lane.velocities[(size_t) i]), sample);
+    }
+
+    // Note-offs for the lane's sounding notes; forgets them unless they're about to be retriggered
+    void stopNotes(int index, juce::MidiBuffer& midi, int sample, bool forget = true)
+    {
+        auto& lane = lanes[(size_t) index];
+        for (int i = 0; i < lane.numNotes; ++i)
+            midi.addEvent(juce::MidiMessage::noteOff(getLaneChannel(index), lane.notes[(size_t) i]), sample);
+
+        if (forget)
+            lane.numNotes = 0;
+    }
+};
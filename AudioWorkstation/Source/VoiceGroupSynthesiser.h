@@ -0,0 +1,168 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <bitset>
+#include <functional>
+#include <vector>
+#include "ParallelVoiceRenderer.h"
+
+// Synthesiser whose voices can be reserved for a MIDI channel. Notes on a
+// reserved channel only start (or steal) voices from that channel's group;
+// every other channel shares the unreserved voices. Each group therefore has a
+// guaranteed polyphony, and a busy group can't take voices from another.
+//
+// Groups are set up along with the voices, before playback starts.
+//
+// It also keeps each channel's last pressure and timbre (CC74) and hands them
+// to a voice as its note starts: an MPE controller sends a note's initial
+// expression on its channel just before the note-on, when no voice is yet
+// playing that channel to receive it.
+//
+// With an MPE zone master channel set, bends on that channel move every voice
+// by up to 2 semitones through the zone bend handler, on top of each note's own
+// (member channel) bend, instead of only notes on the master channel.
+//
+// With a ParallelVoiceRenderer attached, each stretch between MIDI events is
+// offered to it first and rendered serially only when it declines.
+class VoiceGroupSynthesiser : public juce::Synthesiser
+{
+public:
+    // Adds voices reserved for midiChannel (1-16); addVoice() adds shared ones
+    void addReservedVoices(int midiChannel, int numVoices, std::function<juce::SynthesiserVoice*()> createVoice)
+    {
+        jassert(juce::isPositiveAndBelow(midiChannel - 1, 16));
+
+        for (int i = 0; i < numVoices; ++i)
+        {
+            addVoice(createVoice());
+            voiceChannels.resize((size_t) getNumVoices(), 0);
+            voiceChannels.back() = midiChannel;
+        }
+
+        reservedChannels.set((size_t) midiChannel);
+    }
+
+    void setParallelRenderer(ParallelVoiceRenderer* rendererToUse) { parallelRenderer = rendererToUse; }
+
+    // Passes a master-channel wheel value (0-16383) to one voice; set along with the voices
+    void setZoneBendHandler(std::function<void(juce::SynthesiserVoice&, int)> handler) { zoneBendHandler = std::move(handler); }
+
+    // Audio thread. 1 for an MPE lower zone, 0 when there's no zone; a change recentres the zone bend
+    void setZoneMasterChannel(int midiChannel)
+    {
+        if (midiChannel == zoneMasterChannel)
+            return;
+
+        zoneMasterChannel = midiChannel;
+        moveZoneBend(centreWheelValue);
+    }
+
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override
+    {
+        const juce::ScopedLock sl(lock);
+
+        juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
+
+        // The voice that just took the note is the newest one playing it
+        juce::SynthesiserVoice* started = nullptr;
+        for (auto* voice : voices)
+            if (voice->isPlayingChannel(midiChannel) && voice->getCurrentlyPlayingNote() == midiNoteNumber
+                && (started == nullptr || started->wasStartedBefore(*voice)))
+                started = voice;
+
+        if (started != nullptr && juce::isPositiveAndBelow(midiChannel, 17))
+        {
+            started->channelPressureChanged(channelPressures[(size_t) midiChannel]);
+            started->controllerMoved(timbreController, channelTimbres[(size_t) midiChannel]);
+        }
+    }
+
+    void handleController(int midiChannel, int controllerNumber, int controllerValue) override
+    {
+        if (controllerNumber == timbreController && juce::isPositiveAndBelow(midiChannel, 17))
+            channelTimbres[(size_t) midiChannel] = controllerValue;
+
+        juce::Synthesiser::handleController(midiChannel, controllerNumber, controllerValue);
+    }
+
+    void handlePitchWheel(int midiChannel, int wheelValue) override
+    {
+        if (midiChannel != zoneMasterChannel)
+            juce::Synthesiser::handlePitchWheel(midiChannel, wheelValue);
+        else
+            moveZoneBend(wheelValue);
+    }
+
+    void handleChannelPressure(int midiChannel, int channelPressureValue) override
+    {
+        if (juce::isPositiveAndBelow(midiChannel, 17))
+            channelPressures[(size_t) midiChannel] = channelPressureValue;
+
+        juce::Synthesiser::handleChannelPressure(midiChannel, channelPressureValue);
+    }
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override
+    {
+        if (parallelRenderer == nullptr || ! parallelRenderer->render(voices, outputAudio, startSample, numSamples))
+            juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+    }
+
+    juce::SynthesiserVoice* findFreeVoice(juce::SynthesiserSound* sound, int midiChannel,
+                                          int midiNoteNumber, bool stealIfNoneAvailable) const override
+    {
+        const juce::ScopedLock sl(lock);
+
+        auto group = reservedChannels[(size_t) juce::jlimit(0, 16, midiChannel)] ? midiChannel : 0;
+        juce::SynthesiserVoice* oldest = nullptr;
+        juce::SynthesiserVoice* oldestReleased = nullptr;
+
+        for (int i = 0; i < voices.size(); ++i)
+        {
+            auto* voice = voices.getUnchecked(i);
+            auto voiceGroup = i < (int) voiceChannels.size() ? voiceChannels[(size_t) i] : 0;
+
+            if (voiceGroup != group || ! voice->canPlaySound(sound))
+                continue;
+
+            if (! voice->isVoiceActive())
+                return voice;
+
+            // Stealing stays inside the group: the oldest released voice, otherwise the oldest
+            if (voice->isPlayingButReleased() && (oldestReleased == nullptr || voice->wasStartedBefore(*oldestReleased)))
+                oldestReleased = voice;
+
+            if (oldest == nullptr || voice->wasStartedBefore(*oldest))
+                oldest = voice;
+        }
+
+        juce::ignoreUnused(midiNoteNumber);
+
+        if (! stealIfNoneAvailable)
+            return nullptr;
+
+        return oldestReleased != nullptr ? oldestReleased : oldest;
+    }
+
+private:
+    static constexpr int timbreController = 74;
+    static constexpr int centreWheelValue = 8192;
+
+    // Every voice, sounding or not, so notes started later pick the bend up too
+    void moveZoneBend(int wheelValue)
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (zoneBendHandler != nullptr)
+            for (auto* voice : voices)
+                zoneBendHandler(*voice, wheelValue);
+    }
+
+    ParallelVoiceRenderer* parallelRenderer = nullptr;
+    std::function<void(juce::SynthesiserVoice&, int)> zoneBendHandler;
+    int zoneMasterChannel = 0;
+    std::vector<int> voiceChannels; // Per voice: the reserving channel, or 0 for shared
+    std::bitset<17> reservedChannels;
+    std::array<int, 17> channelPressures {};
+    std::array<int, 17> channelTimbres { 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64 };
+};
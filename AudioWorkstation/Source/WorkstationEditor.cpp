@@ -96,6 +96,40 @@ WorkstationEditor::WorkstationEditor(WorkstationProcessor& p) : juce::AudioProce
     addAndMakeVisible(lfoWaveformSelector);
     lfoWaveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         processor.getValueTreeState(), "lfoWaveform", lfoWaveformSelector);
+
+    // Unison stack
+    setupSlider(unisonVoicesSlider, unisonVoicesLabel, "Unison", "unisonVoices");
+    setupSlider(unisonDetuneSlider, unisonDetuneLabel, "Detune", "unisonDetune");
+    setupSlider(unisonSpreadSlider, unisonSpreadLabel, "Spread", "unisonSpread");
+    unisonVoicesSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 30, 16); // The count matters more than the position
+
+    // Multi-core voice rendering: the slider is the voice count it starts at
+    setupSlider(multiCoreVoicesSlider, multiCoreLabel, "Cores from", "multiCoreVoices");
+    multiCoreVoicesSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 30, 16);
+    multiCoreVoicesSlider.setTooltip("Voices sounding before rendering spreads across cores");
+
+    multiCoreButton.setButtonText("Multi-core");
+    multiCoreButton.setTooltip("Render voices on several cores when many are sounding");
+    addAndMakeVisible(multiCoreButton);
+    multiCoreAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getValueTreeState(), "multiCore", multiCoreButton);
+
+    // Oversampling selector with render-only high quality switch
+    oversamplingLabel.setText("Oversample", juce::dontSendNotification);
+    oversamplingLabel.setJustificationType(juce::Justification::centredLeft);
+    oversamplingLabel.setFont(juce::FontOptions(12.0f));
+    addAndMakeVisible(oversamplingLabel);
+
+    oversamplingSelector.addItemList({"1x", "2x", "4x", "8x"}, 1);
+    addAndMakeVisible(oversamplingSelector);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processor.getValueTreeState(), "oversampling", oversamplingSelector);
+
+    renderHighQualityButton.setButtonText("HQ Render");
+    renderHighQualityButton.setTooltip("Offline bounces also use 8x oversampling (live monitoring is padded to its latency); they always get dense reverb and band-limited oscillators");
+    addAndMakeVisible(renderHighQualityButton);
+    renderHighQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getValueTreeState(), "renderHighQuality", renderHighQualityButton);
     
     // EQ controls
     setupSlider(lowShelfFreqSlider, lowShelfLabel, "Low Shelf", "lowShelfFreq");
@@ -118,12 +152,97 @@ WorkstationEditor::WorkstationEditor(WorkstationProcessor& p) : juce::AudioProce
     setupSlider(reverbDampingSlider, reverbDampingLabel, "Damping", "reverbDamping");
     setupSlider(reverbWetLevelSlider, reverbWetLevelLabel, "Wet Level", "reverbWetLevel");
     setupSlider(reverbDryLevelSlider, reverbDryLevelLabel, "Dry Level", "reverbDryLevel");
+
+    // Reverb mode selector (Fast for live, Dense for bounces)
+    reverbModeSelector.addItemList({"Classic", "Fast", "Dense", "Convolution"}, 1);
+    addAndMakeVisible(reverbModeSelector);
+    reverbModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processor.getValueTreeState(), "reverbMode", reverbModeSelector);
+
+    // Impulse response loader for the convolution mode
+    loadImpulseResponseButton.setButtonText("IR...");
+    loadImpulseResponseButton.onClick = [this]() { chooseImpulseResponse(); };
+    if (processor.getImpulseResponseFile().existsAsFile())
+        loadImpulseResponseButton.setTooltip(processor.getImpulseResponseFile().getFileName());
+    addAndMakeVisible(loadImpulseResponseButton);
+
+    // Snapshot morph: click a slot to store the current sound, shift-click to clear it
+    setupSlider(morphSlider, morphLabel, "Morph", "morph");
+    morphLabel.setColour(juce::Label::textColourId, juce::Colours::gold);
+
+    for (int slot = 0; slot < (int) morphSnapshotButtons.size(); ++slot)
+    {
+        auto& button = morphSnapshotButtons[(size_t) slot];
+        button.setButtonText(juce::String::charToString((juce::juce_wchar) ('A' + slot)));
+        button.setTooltip("Click to store the current sound for morphing, shift-click to clear");
+        button.setColour(juce::TextButton::buttonOnColourId, juce::Colours::darkgoldenrod);
+        button.onClick = [this, slot]() {
+            if (juce::ModifierKeys::currentModifiers.isShiftDown())
+                processor.clearMorphSnapshot(slot);
+            else
+                processor.storeMorphSnapshot(slot);
+
+            updateMorphSnapshotButtons();
+        };
+        addAndMakeVisible(button);
+    }
+    updateMorphSnapshotButtons();
     
     
     // Create visualizer and MIDI pattern components
     eqVisualizer = std::make_unique<EQVisualizerComponent>(processor);
     addAndMakeVisible(*eqVisualizer);
+
+    // GPU spectrum rendering, falling back to software if the GL context can't be used
+    eqVisualizer->setOpenGLEnabled(true);
+    gpuSpectrumButton.setButtonText("GPU");
+    gpuSpectrumButton.setTooltip("Draw the spectrum with OpenGL instead of the software renderer");
+    gpuSpectrumButton.setToggleState(eqVisualizer->isOpenGLEnabled(), juce::dontSendNotification);
+    gpuSpectrumButton.onClick = [this]() {
+        eqVisualizer->setOpenGLEnabled(gpuSpectrumButton.getToggleState());
+    };
+    eqVisualizer->onOpenGLFailure = [this](const juce::String& error) {
+        gpuSpectrumButton.setToggleState(false, juce::dontSendNotification);
+        gpuSpectrumButton.setTooltip("OpenGL unavailable, using the software renderer: " + error);
+    };
+    addAndMakeVisible(gpuSpectrumButton);
+
+    // Visualizer mode: spectrum bars, scrolling spectrogram or triggered oscilloscope
+    displayModeSelector.addItemList({"Spectrum", "Waterfall", "Scope (Pitch Lock)", "Scope (Zero Cross)"}, 1);
+    displayModeSelector.setSelectedItemIndex(0, juce::dontSendNotification);
+    displayModeSelector.onChange = [this]() {
+        using Mode = EQVisualizerComponent::DisplayMode;
+        auto index = displayModeSelector.getSelectedItemIndex();
+
+        if (index >= 2)
+            processor.setScopeTriggerMode(index == 2 ? ScopeCapture::TriggerMode::PitchLocked
+                                                     : ScopeCapture::TriggerMode::ZeroCrossing);
+
+        eqVisualizer->setDisplayMode(index == 1 ? Mode::Spectrogram : index >= 2 ? Mode::Oscilloscope : Mode::Spectrum);
+    };
+    addAndMakeVisible(displayModeSelector);
+
+    // Preset library: selecting one switches at the next audio block
+    presetSelector.setTextWhenNothingSelected("Presets");
+    presetSelector.onChange = [this]() {
+        auto index = presetSelector.getSelectedItemIndex();
+        if (index >= 0 && index != processor.getCurrentProgram())
+            processor.setCurrentProgram(index);
+    };
+    addAndMakeVisible(presetSelector);
+
+    savePresetButton.setButtonText("Save");
+    savePresetButton.setTooltip("Store the current sound as a new preset");
+    savePresetButton.onClick = [this]() {
+        if (processor.savePreset("Preset " + juce::String(processor.getPresetNames().size() + 1)) >= 0)
+            refreshPresetList();
+    };
+    addAndMakeVisible(savePresetButton);
+    refreshPresetList();
     
+    levelMeter = std::make_unique<LevelMeterComponent>(processor);
+    addAndMakeVisible(*levelMeter);
+
     midiPattern = std::make_unique<MIDIPatternComponent>(processor);
     addAndMakeVisible(*midiPattern);
     
@@ -200,6 +319,64 @@ WorkstationEditor::WorkstationEditor(WorkstationProcessor& p) : juce::AudioProce
     midiRandomizeButton.setColour(juce::TextButton::buttonColourId, juce::Colours::darkorange);
     globalRandomizeButton.setColour(juce::TextButton::buttonColourId, juce::Colours::purple);
 
+    // Live MIDI stage row
+    liveLabel.setText("LIVE", juce::dontSendNotification);
+    liveLabel.setFont(juce::FontOptions(12.0f).withStyle("bold"));
+    liveLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(liveLabel);
+
+    arpModeSelector.addItemList({"Arp Off", "Up", "Down", "Up/Down", "As Played", "Random", "Chord"}, 1);
+    arpModeSelector.setTooltip("Arpeggiator mode for notes played on the keyboard");
+    addAndMakeVisible(arpModeSelector);
+    arpModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processor.getValueTreeState(), "arpMode", arpModeSelector);
+
+    arpRateSelector.addItemList({"1/4", "1/8", "1/16", "1/32", "1/8T", "1/16T"}, 1);
+    addAndMakeVisible(arpRateSelector);
+    arpRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processor.getValueTreeState(), "arpRate", arpRateSelector);
+
+    for (auto* slider : { &arpOctavesSlider, &arpGateSlider })
+    {
+        slider->setSliderStyle(juce::Slider::LinearHorizontal);
+        slider->setTextBoxStyle(juce::Slider::TextBoxRight, false, 40, 18);
+        addAndMakeVisible(*slider);
+    }
+
+    arpOctavesSlider.setTooltip("Octaves the arpeggiator spans");
+    arpGateSlider.setTooltip("Arpeggiated note length, as a fraction of a step");
+    arpOctavesAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        processor.getValueTreeState(), "arpOctaves", arpOctavesSlider);
+    arpGateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        processor.getValueTreeState(), "arpGate", arpGateSlider);
+
+    chordMemoryButton.setButtonText("Chord");
+    chordMemoryButton.setTooltip("Each key plays the learned chord shape");
+    addAndMakeVisible(chordMemoryButton);
+    chordMemoryAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getValueTreeState(), "chordMemory", chordMemoryButton);
+
+    learnChordButton.setButtonText("Learn");
+    learnChordButton.setTooltip("Hold a chord and click to store its shape");
+    learnChordButton.onClick = [this]
+    {
+        learnChordButton.setTooltip(processor.learnChordMemory() ? "Chord shape learned"
+                                                                 : "Hold at least two keys, then click to store their shape");
+    };
+    addAndMakeVisible(learnChordButton);
+
+    scaleQuantiseButton.setButtonText("Scale");
+    scaleQuantiseButton.setTooltip("Snap played notes to the generator's key and mode");
+    addAndMakeVisible(scaleQuantiseButton);
+    scaleQuantiseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getValueTreeState(), "scaleQuantise", scaleQuantiseButton);
+
+    mpeButton.setButtonText("MPE");
+    mpeButton.setTooltip("Per-note bend (48 semitones), pressure and slide from an MPE controller on any member channels, with channel 1 bending the whole zone by 2 semitones");
+    addAndMakeVisible(mpeButton);
+    mpeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getValueTreeState(), "mpe", mpeButton);
+
     // Octave radio buttons setup (only in standalone mode)
     if (isStandalone) {
         octaveLabel.setText("OCTAVE", juce::dontSendNotification);
@@ -252,12 +429,28 @@ void WorkstationEditor::resized()
     
     // Bottom control strip: MIDI + Global controls
     bool isStandalone = processor.wrapperType == juce::AudioProcessor::wrapperType_Standalone;
-    auto bottomStripHeight = isStandalone ? 150 : 90; // Much less height needed when MIDI controls hidden
+    auto bottomStripHeight = isStandalone ? 175 : 115; // Much less height needed when MIDI controls hidden
     auto bottomStrip = bounds.removeFromBottom(bottomStripHeight);
     auto midiHeader = bottomStrip.removeFromTop(25);
     midiLabel.setBounds(midiHeader.removeFromLeft(150));
     globalRandomizeButton.setBounds(midiHeader.removeFromRight(120).reduced(2));
     midiRandomizeButton.setBounds(midiHeader.removeFromRight(80).reduced(2));
+    gpuSpectrumButton.setBounds(midiHeader.removeFromRight(60).reduced(2));
+    displayModeSelector.setBounds(midiHeader.removeFromRight(150).reduced(2));
+    savePresetButton.setBounds(midiHeader.removeFromRight(50).reduced(2));
+    presetSelector.setBounds(midiHeader.removeFromRight(150).reduced(2));
+
+    // Live MIDI stage row
+    auto liveRow = bottomStrip.removeFromTop(25);
+    liveLabel.setBounds(liveRow.removeFromLeft(60));
+    arpModeSelector.setBounds(liveRow.removeFromLeft(110).reduced(2));
+    arpRateSelector.setBounds(liveRow.removeFromLeft(75).reduced(2));
+    arpOctavesSlider.setBounds(liveRow.removeFromLeft(110).reduced(2));
+    arpGateSlider.setBounds(liveRow.removeFromLeft(130).reduced(2));
+    chordMemoryButton.setBounds(liveRow.removeFromLeft(65).reduced(2));
+    learnChordButton.setBounds(liveRow.removeFromLeft(55).reduced(2));
+    scaleQuantiseButton.setBounds(liveRow.removeFromLeft(65).reduced(2));
+    mpeButton.setBounds(liveRow.removeFromLeft(60).reduced(2));
 
     // MIDI device selection row (only in standalone mode)
     if (isStandalone) {
@@ -292,8 +485,8 @@ void WorkstationEditor::resized()
     synthLabel.setBounds(synthHeader.removeFromLeft(150));
     synthRandomizeButton.setBounds(synthHeader.removeFromRight(80).reduced(2));
     
-    // Synth controls (13 controls now - expanded from 7)
-    auto synthControls = rightStrip.removeFromTop(260); // Compact height for all controls
+    // Synth controls (18 rows including unison and multi-core)
+    auto synthControls = rightStrip.removeFromTop(326); // Compact height for all controls
     int sliderHeight = 18; // Reduced from 22
     int spacing = 1; // Reduced from 2
     int labelWidth = 75; // Slightly narrower labels
@@ -333,6 +526,24 @@ void WorkstationEditor::resized()
     setupSliderRow(lfoRateSlider, lfoRateLabel);
     setupSliderRow(lfoDepthSlider, lfoDepthLabel);
     setupComboRow(lfoWaveformSelector, lfoWaveformLabel);
+
+    // Unison controls
+    setupSliderRow(unisonVoicesSlider, unisonVoicesLabel);
+    setupSliderRow(unisonDetuneSlider, unisonDetuneLabel);
+    setupSliderRow(unisonSpreadSlider, unisonSpreadLabel);
+
+    // Multi-core threshold with its on/off toggle alongside
+    auto multiCoreRow = synthControls.removeFromTop(sliderHeight);
+    multiCoreLabel.setBounds(multiCoreRow.removeFromLeft(labelWidth));
+    multiCoreButton.setBounds(multiCoreRow.removeFromRight(95));
+    multiCoreVoicesSlider.setBounds(multiCoreRow.reduced(2, 0));
+    synthControls.removeFromTop(spacing);
+
+    // Oversampling factor with the HQ render toggle alongside
+    auto oversamplingRow = synthControls.removeFromTop(sliderHeight);
+    oversamplingLabel.setBounds(oversamplingRow.removeFromLeft(labelWidth));
+    renderHighQualityButton.setBounds(oversamplingRow.removeFromRight(95));
+    oversamplingSelector.setBounds(oversamplingRow.reduced(2, 0));
     
     rightStrip.removeFromTop(10); // Section spacing
     
@@ -399,9 +610,11 @@ void WorkstationEditor::resized()
     auto reverbHeader = rightStrip.removeFromTop(25);
     reverbLabel.setBounds(reverbHeader.removeFromLeft(80));
     reverbRandomizeButton.setBounds(reverbHeader.removeFromRight(80).reduced(2));
+    loadImpulseResponseButton.setBounds(reverbHeader.removeFromRight(45).reduced(2));
+    reverbModeSelector.setBounds(reverbHeader.reduced(5, 2));
     
     // Reverb controls (4 horizontal sliders - compact)
-    auto reverbControls = rightStrip.removeFromTop(90);
+    auto reverbControls = rightStrip.removeFromTop(76);
     
     auto setupReverbRow = [&](juce::Slider& slider, juce::Label& label, const juce::String& text) {
         auto row = reverbControls.removeFromTop(sliderHeight);
@@ -416,83 +629,94 @@ void WorkstationEditor::resized()
     setupReverbRow(reverbWetLevelSlider, reverbWetLevelLabel, "Wet Level");
     setupReverbRow(reverbDryLevelSlider, reverbDryLevelLabel, "Dry Level");
     
-    rightStrip.removeFromTop(10); // Section spacing
+    rightStrip.removeFromTop(5); // Section spacing
+
+    // Morph macro with its snapshot slots
+    auto morphRow = rightStrip.removeFromTop(22);
+    morphLabel.setBounds(morphRow.removeFromLeft(labelWidth));
+    for (auto& button : morphSnapshotButtons)
+        button.setBounds(morphRow.removeFromLeft(28).reduced(1));
+    morphSlider.setBounds(morphRow.reduced(2, 0));
     
     
+    bounds.removeFromRight(10); // Spacing
+
+    // Output meters between the analyzer and the controls
+    levelMeter->setBounds(bounds.removeFromRight(90));
     bounds.removeFromRight(10); // Spacing
     
     // CENTER: Large FFT spectrum analyzer takes remaining space
     eqVisualizer->setBounds(bounds);
 }
 
+// The randomizers hand their values to the processor, which glides the sound
+// there on the morph path; the controls follow once the values are set
 void WorkstationEditor::randomizeSynth()
 {
     auto& random = juce::Random::getSystemRandom();
+    juce::NamedValueSet values;
 
-    // Randomize waveform type (0-3: Sine, Saw, Square, Triangle)
-    waveformSelector.setSelectedItemIndex(random.nextInt(4));
-
-    // Randomize filter type (0-3: Lowpass, Highpass, Bandpass, Notch)
-    filterTypeSelector.setSelectedItemIndex(random.nextInt(4));
+    // Waveform (Sine, Saw, Square, Triangle) and filter type (Lowpass, Highpass, Bandpass, Notch)
+    values.set("waveform", random.nextInt(4));
+    values.set("filterType", random.nextInt(4));
 
     // Randomize ADSR (keeping musical values)
-    attackSlider.setValue(random.nextFloat() * 2.0f); // 0-2 seconds
-    decaySlider.setValue(random.nextFloat() * 3.0f); // 0-3 seconds
-    sustainSlider.setValue(0.1f + random.nextFloat() * 0.8f); // 0.1-0.9
-    releaseSlider.setValue(random.nextFloat() * 4.0f); // 0-4 seconds
+    values.set("attack", random.nextFloat() * 2.0f); // 0-2 seconds
+    values.set("decay", random.nextFloat() * 3.0f); // 0-3 seconds
+    values.set("sustain", 0.1f + random.nextFloat() * 0.8f); // 0.1-0.9
+    values.set("release", random.nextFloat() * 4.0f); // 0-4 seconds
 
     // Randomize filter (keeping reasonable values)
-    filterCutoffSlider.setValue(100.0f + random.nextFloat() * 3000.0f); // 100-3100 Hz (musical range)
-    filterResonanceSlider.setValue(0.1f + random.nextFloat() * 3.0f); // 0.1-3.1 (musical range)
-
+    values.set("filterCutoff", 100.0f + random.nextFloat() * 3000.0f); // 100-3100 Hz (musical range)
+    values.set("filterResonance", 0.1f + random.nextFloat() * 3.0f); // 0.1-3.1 (musical range)
 
     // Randomize distortion (mild to heavy)
-    distortionSlider.setValue(1.0f + random.nextFloat() * 5.0f); // 1.0-6.0
+    values.set("distortion", 1.0f + random.nextFloat() * 5.0f); // 1.0-6.0
 
     // Randomize LFO parameters
-    lfoRateSlider.setValue(0.1f + random.nextFloat() * 10.0f); // 0.1-10 Hz (musical range)
-    lfoDepthSlider.setValue(random.nextFloat() * 0.5f); // 0-0.5 (not too extreme)
-    lfoWaveformSelector.setSelectedItemIndex(random.nextInt(4)); // Random LFO waveform
+    values.set("lfoRate", 0.1f + random.nextFloat() * 10.0f); // 0.1-10 Hz (musical range)
+    values.set("lfoDepth", random.nextFloat() * 0.5f); // 0-0.5 (not too extreme)
+    values.set("lfoWaveform", random.nextInt(4));
+
+    processor.glideToParameters(values);
 }
 
 void WorkstationEditor::randomizeEQ()
 {
     auto& random = juce::Random::getSystemRandom();
-    
+    juce::NamedValueSet values;
+
     // Low shelf
-    lowShelfFreqSlider.setValue(80.0f + random.nextFloat() * 320.0f); // 80-400 Hz
-    lowShelfGainSlider.setValue(-12.0f + random.nextFloat() * 24.0f); // -12 to +12 dB
-    
+    values.set("lowShelfFreq", 80.0f + random.nextFloat() * 320.0f); // 80-400 Hz
+    values.set("lowShelfGain", -12.0f + random.nextFloat() * 24.0f); // -12 to +12 dB
+
     // Peak filters with musical frequency ranges
-    peak1FreqSlider.setValue(200.0f + random.nextFloat() * 800.0f); // 200-1000 Hz
-    peak1GainSlider.setValue(-12.0f + random.nextFloat() * 24.0f);
-    peak1QSlider.setValue(0.5f + random.nextFloat() * 4.5f); // 0.5-5.0
-    
-    
-    peak3FreqSlider.setValue(2000.0f + random.nextFloat() * 18000.0f); // 2-20 kHz
-    peak3GainSlider.setValue(-12.0f + random.nextFloat() * 24.0f);
-    peak3QSlider.setValue(0.5f + random.nextFloat() * 4.5f);
-    
+    values.set("peak1Freq", 200.0f + random.nextFloat() * 800.0f); // 200-1000 Hz
+    values.set("peak1Gain", -12.0f + random.nextFloat() * 24.0f);
+    values.set("peak1Q", 0.5f + random.nextFloat() * 4.5f); // 0.5-5.0
+
+    values.set("peak3Freq", 2000.0f + random.nextFloat() * 18000.0f); // 2-20 kHz
+    values.set("peak3Gain", -12.0f + random.nextFloat() * 24.0f);
+    values.set("peak3Q", 0.5f + random.nextFloat() * 4.5f);
+
     // High shelf (keep in audible range)
-    highShelfFreqSlider.setValue(6000.0f + random.nextFloat() * 14000.0f); // 6-20 kHz (audible range)
-    highShelfGainSlider.setValue(-12.0f + random.nextFloat() * 24.0f);
+    values.set("highShelfFreq", 6000.0f + random.nextFloat() * 14000.0f); // 6-20 kHz (audible range)
+    values.set("highShelfGain", -12.0f + random.nextFloat() * 24.0f);
+
+    processor.glideToParameters(values);
 }
 
 void WorkstationEditor::randomizeReverb()
 {
     auto& random = juce::Random::getSystemRandom();
-    
-    // Room size (small to large)
-    reverbRoomSizeSlider.setValue(0.1f + random.nextFloat() * 0.8f); // 0.1-0.9
-    
-    // Damping (bright to dark)
-    reverbDampingSlider.setValue(random.nextFloat()); // 0.0-1.0
-    
-    // Wet level (subtle to prominent)
-    reverbWetLevelSlider.setValue(0.1f + random.nextFloat() * 0.6f); // 0.1-0.7
-    
-    // Dry level (usually keep high)
-    reverbDryLevelSlider.setValue(0.5f + random.nextFloat() * 0.5f); // 0.5-1.0
+    juce::NamedValueSet values;
+
+    values.set("reverbRoomSize", 0.1f + random.nextFloat() * 0.8f); // Small to large, 0.1-0.9
+    values.set("reverbDamping", random.nextFloat()); // Bright to dark
+    values.set("reverbWetLevel", 0.1f + random.nextFloat() * 0.6f); // Subtle to prominent, 0.1-0.7
+    values.set("reverbDryLevel", 0.5f + random.nextFloat() * 0.5f); // Usually kept high, 0.5-1.0
+
+    processor.glideToParameters(values);
 }
 
 void WorkstationEditor::refreshMidiDevices()
@@ -520,4 +744,42 @@ void WorkstationEditor::refreshMidiDevices()
         midiDeviceSelector.setSelectedItemIndex(deviceNames.size() - 1, juce::dontSendNotification);
         processor.setSelectedMidiDevice(deviceNames[deviceNames.size() - 1]);
     }
+}
+
+void WorkstationEditor::refreshPresetList()
+{
+    auto names = processor.getPresetNames();
+
+    presetSelector.clear(juce::dontSendNotification);
+    presetSelector.addItemList(names, 1);
+
+    if (names.size() > 0)
+        presetSelector.setSelectedItemIndex(processor.getCurrentProgram(), juce::dontSendNotification);
+}
+
+void WorkstationEditor::updateMorphSnapshotButtons()
+{
+    for (int slot = 0; slot < (int) morphSnapshotButtons.size(); ++slot)
+        morphSnapshotButtons[(size_t) slot].setToggleState(processor.hasMorphSnapshot(slot), juce::dontSendNotification);
+}
+
+void WorkstationEditor::chooseImpulseResponse()
+{
+    impulseResponseChooser = std::make_unique<juce::FileChooser>(
+        "Load impulse response", processor.getImpulseResponseFile(), "*.wav;*.aif;*.aiff");
+
+    auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+
+    impulseResponseChooser->launchAsync(flags, [this](const juce::FileChooser& chooser)
+    {
+        auto file = chooser.getResult();
+        if (!file.existsAsFile())
+            return;
+
+        processor.loadImpulseResponse(file);
+        loadImpulseResponseButton.setTooltip(file.getFileName());
+
+        // Switch to convolution mode so the new room is heard straight away
+        reverbModeSelector.setSelectedItemIndex(static_cast<int>(ReverbMode::Convolution));
+    });
 }
\ No newline at end of file
@@ -3,15 +3,87 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include "WorkstationProcessor.h"
+#include "SpectrumGLRenderer.h"
+#include "SpectrogramView.h"
 
-class EQVisualizerComponent : public juce::Component, public juce::Timer
+// Spectrum bar colours, indexed by bar position and quantised level. Rebuilt
+// whenever the base hues change, so drawing a frame never converts from HSV.
+class SpectrumColourTable
 {
 public:
-    EQVisualizerComponent(WorkstationProcessor& p) : processor(p)
+    static constexpr int numPositions = 300; // One per spectrum bar
+    static constexpr int numLevels = 64;
+
+    void build(float hue1, float hue2)
+    {
+        glowColours.resize(numPositions * numLevels);
+        barColours.resize(numPositions * numLevels);
+        peakColours.resize(numPositions * numLevels);
+
+        for (int position = 0; position < numPositions; ++position)
+        {
+            // Simple two-colour gradient based on frequency position
+            float hue = hue1 + (hue2 - hue1) * (float) position / (float) numPositions;
+
+            for (int levelIndex = 0; levelIndex < numLevels; ++levelIndex)
+            {
+                float level = (float) levelIndex / (float) (numLevels - 1);
+                auto index = (size_t) (position * numLevels + levelIndex);
+
+                // Background glow for stronger signals, more vivid and brighter bars at higher levels
+                glowColours[index] = juce::Colour::fromHSV(hue, 0.6f, 0.4f + level * 0.3f, 0.3f);
+                barColours[index] = juce::Colour::fromHSV(hue, 0.7f + level * 0.3f, 0.5f + level * 0.5f, 0.85f);
+                peakColours[index] = juce::Colour::fromHSV(hue, 0.9f, 0.9f + level * 0.1f, 0.95f);
+            }
+        }
+    }
+
+    // level is the bar's scaled magnitude (or peak) in 0-1
+    juce::Colour getGlowColour(int position, float level) const noexcept { return glowColours[getIndex(position, level)]; }
+    juce::Colour getBarColour(int position, float level) const noexcept  { return barColours[getIndex(position, level)]; }
+    juce::Colour getPeakColour(int position, float level) const noexcept { return peakColours[getIndex(position, level)]; }
+
+private:
+    std::vector<juce::Colour> glowColours, barColours, peakColours;
+
+    static size_t getIndex(int position, float level) noexcept
+    {
+        auto levelIndex = juce::jlimit(0, numLevels - 1, (int) (level * (float) (numLevels - 1) + 0.5f));
+        return (size_t) (juce::jlimit(0, numPositions - 1, position) * numLevels + levelIndex);
+    }
+};
+
+class EQVisualizerComponent : public juce::Component,
+                              private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    EQVisualizerComponent(WorkstationProcessor& p) : processor(p), glRenderer(*this)
     {
-        startTimer(60); // 15fps updates (60ms interval)
+        // A GL context that can't compile the shaders drops back to software painting
+        glRenderer.onFailure = [this](const juce::String& error)
+        {
+            glRenderer.detach();
+            repaint();
+
+            if (onOpenGLFailure != nullptr)
+                onOpenGLFailure(error);
+        };
+
+        // EQ curves are only recomputed when one of these moves
+        for (auto* id : eqParameterIDs)
+            processor.getValueTreeState().addParameterListener(id, this);
+
+        // Frames are driven by the display refresh - see onVBlank()
         generateRandomColours(); // Start with random colours
     }
+
+    ~EQVisualizerComponent() override
+    {
+        for (auto* id : eqParameterIDs)
+            processor.getValueTreeState().removeParameterListener(id, this);
+
+        glRenderer.detach();
+    }
     
     void generateRandomColours()
     {
@@ -26,201 +98,648 @@ public:
         {
             baseHue2 = random.nextFloat();
         }
+
+        colourTable.build(baseHue1, baseHue2);
+        spectrogram.setColours(baseHue1, baseHue2);
     }
     
     void onPlayPressed()
     {
         generateRandomColours();
     }
+
+    // Spectrum, peak hold and EQ curves on the GPU; grid, labels and branding
+    // are still painted by the component on top
+    void setOpenGLEnabled(bool shouldUseOpenGL)
+    {
+        if (shouldUseOpenGL == glRenderer.isActive())
+            return;
+
+        if (shouldUseOpenGL)
+            glRenderer.attach();
+        else
+            glRenderer.detach();
+
+        repaint();
+    }
+
+    bool isOpenGLEnabled() const
+    {
+        return glRenderer.isActive();
+    }
+
+    // Called with the shader compiler's error once the GL layer has fallen back to software
+    std::function<void(const juce::String&)> onOpenGLFailure;
+
+    enum class DisplayMode
+    {
+        Spectrum,
+        Spectrogram,
+        Oscilloscope
+    };
+
+    // Spectrogram is a scrolling waterfall for spotting masking in dense patches;
+    // the oscilloscope shows triggered sweeps of the output
+    void setDisplayMode(DisplayMode newMode)
+    {
+        if (newMode == displayMode)
+            return;
+
+        displayMode = newMode;
+        lastAnalysisFrame = processor.getFFTFrameCount();
+
+        // The GL layer only draws the spectrum; clear it while the waterfall is showing
+        spectrumVertices.clear();
+        glRenderer.setVertices(spectrumVertices, (float) getWidth(), (float) getHeight());
+        curvesDirty = true;
+        repaint();
+    }
+
+    DisplayMode getDisplayMode() const
+    {
+        return displayMode;
+    }
     
     void paint(juce::Graphics& g) override
     {
-        g.fillAll(juce::Colours::black);
-        
-        auto bounds = getLocalBounds().toFloat().reduced(15);
-        
-        // Full-screen FFT Spectrum Analyser
+        auto bounds = getPlotArea();
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (displayMode == DisplayMode::Oscilloscope)
+        {
+            g.fillAll(juce::Colours::black);
+            paintScopeGrid(g, bounds);
+            paintScope(g, bounds);
+            paintBranding(g, bounds);
+            return;
+        }
+
+        if (displayMode == DisplayMode::Spectrogram)
+        {
+            g.fillAll(juce::Colours::black);
+            spectrogram.draw(g, bounds.toNearestInt());
+
+            if (! spectrogramGridLayer.isValid() || spectrogramGridLayerScale != scale)
+                spectrogramGridLayer = renderLayer(scale, spectrogramGridLayerScale,
+                                                   [this, bounds](juce::Graphics& lg) { paintSpectrogramGrid(lg, bounds); });
+
+            g.drawImage(spectrogramGridLayer, getLocalBounds().toFloat());
+            paintBranding(g, bounds);
+            return;
+        }
+
+        // With the GL layer active the spectrum and curves are already underneath us
+        if (! glRenderer.isActive())
+        {
+            g.fillAll(juce::Colours::black);
+            paintSpectrumBars(g, bounds);
+
+            if (! curveLayer.isValid() || curveLayerScale != scale)
+                curveLayer = renderLayer(scale, curveLayerScale, [this, bounds](juce::Graphics& lg) { paintCurves(lg, bounds); });
+
+            g.drawImage(curveLayer, getLocalBounds().toFloat());
+        }
+
+        if (! gridLayer.isValid() || gridLayerScale != scale)
+            gridLayer = renderLayer(scale, gridLayerScale, [this, bounds](juce::Graphics& lg) { paintGrid(lg, bounds); });
+
+        g.drawImage(gridLayer, getLocalBounds().toFloat());
+        paintBranding(g, bounds);
+    }
+
+    void resized() override
+    {
+        // Every cached layer is laid out against the plot area
+        gridLayer = {};
+        curveLayer = {};
+        spectrogramGridLayer = {};
+        curvesDirty = true;
+        lastSpectrumTop = 0.0f;
+    }
+    
+private:
+    // Adaptive frame rate: every vblank while the spectrum is moving, a low rate
+    // while it's static or the peak hold is slowly settling, and no repaints at
+    // all once nothing is visible. Polling the analyser is just two small copies.
+    void onVBlank()
+    {
+        auto bounds = getPlotArea();
+
+        if (displayMode == DisplayMode::Spectrogram)
+        {
+            updateSpectrogram(bounds);
+            return;
+        }
+
+        if (displayMode == DisplayMode::Oscilloscope)
+        {
+            updateScope(bounds);
+            return;
+        }
+
         processor.getFFTData(fftData);
         processor.getFFTPeakHold(peakHoldData);
+
+        // The curves show the EQ as it runs, so a morph or randomize glide redraws them too
+        auto eqVersion = processor.getEQDisplayVersion();
+        if (eqVersion != lastEQDisplayVersion)
+        {
+            lastEQDisplayVersion = eqVersion;
+            curvesDirty = true;
+        }
+
+        auto now = juce::Time::getMillisecondCounterHiRes();
+        bool somethingVisible = findSpectrumTop(bounds) < bounds.getBottom() || lastSpectrumTop < bounds.getBottom();
+
+        bool frameDue = curvesDirty.load()
+                     || measureSpectrumMotion(bounds) >= 1.0f
+                     || (somethingVisible && now - lastFrameTime >= staticFrameIntervalMs);
+
+        if (! frameDue)
+            return;
+
+        lastFrameTime = now;
+        renderFrame(bounds);
+    }
+
+    // One column per analysis frame since the last vblank. Frames that arrived
+    // together repeat the latest magnitudes, which keeps the time axis honest.
+    void updateSpectrogram(juce::Rectangle<float> bounds)
+    {
+        // A new sample rate moves every row, so the grid labels move with them
+        if (spectrogram.setAnalysisScale(processor.getAnalysisSampleRate(), WorkstationProcessor::getFFTSize()))
+        {
+            spectrogramGridLayer = {};
+            repaint(bounds.getSmallestIntegerContainer());
+        }
+
+        auto frame = processor.getFFTFrameCount();
+        auto newFrames = juce::jmin(frame - lastAnalysisFrame, spectrogram.getNumColumns());
+        lastAnalysisFrame = frame;
+
+        if (newFrames <= 0)
+            return;
+
+        processor.getFFTData(fftData);
+        bool wasBlank = spectrogram.isBlank();
+
+        for (int i = 0; i < newFrames; ++i)
+            spectrogram.pushColumn(fftData);
+
+        // A fully black ring scrolls to the same picture; skip the blit
+        if (! (wasBlank && spectrogram.isBlank()))
+            repaint(bounds.getSmallestIntegerContainer());
+    }
+
+    // Repaints whenever a new sweep arrives, unless it and the one on screen are both flat
+    void updateScope(juce::Rectangle<float> bounds)
+    {
+        if (! processor.getScopeFrame(scopeFrame))
+            return;
+
+        bool flat = true;
+        for (int i = 0; i < scopeFrame.numColumnsUsed && flat; ++i)
+            flat = std::abs(scopeFrame.minimum[(size_t) i]) < 1.0e-4f && std::abs(scopeFrame.maximum[(size_t) i]) < 1.0e-4f;
+
+        if (! (flat && scopeFrameFlat))
+            repaint(bounds.getSmallestIntegerContainer());
+
+        scopeFrameFlat = flat;
+    }
+
+    void renderFrame(juce::Rectangle<float> bounds)
+    {
+        bool curvesChanged = curvesDirty.exchange(false);
+        if (curvesChanged)
+            updateCurves(bounds);
+
+        storeDrawnLevels(bounds);
+
+        if (glRenderer.isActive())
+        {
+            buildSpectrumVertices(bounds);
+            glRenderer.setVertices(spectrumVertices, (float) getWidth(), (float) getHeight());
+        }
+
+        // Dirty regions: only the rows the bars covered last frame or cover now,
+        // plus the branding when its pulse changed. Everything above the
+        // spectrum is cached layers that can't have changed.
+        auto spectrumTop = findSpectrumTop(bounds);
+        auto brandColour = getBrandColour();
+
+        if (curvesChanged)
+        {
+            repaint(bounds.getSmallestIntegerContainer());
+        }
+        else
+        {
+            auto dirtyTop = std::min(spectrumTop, lastSpectrumTop);
+            if (dirtyTop < bounds.getBottom())
+                repaint(bounds.withTop(dirtyTop).getSmallestIntegerContainer());
+
+            if (brandColour != lastBrandColour)
+                repaint(getBrandArea(bounds).getSmallestIntegerContainer());
+        }
+
+        lastSpectrumTop = spectrumTop;
+        lastBrandColour = brandColour;
+    }
+
+    WorkstationProcessor& processor;
+    std::vector<float> frequencies, magnitudes;
+    std::vector<float> waveformData, fftData, peakHoldData;
+    std::vector<float> lowShelfResponse, peak1Response, peak3Response, highShelfResponse;
+    float baseHue1, baseHue2;
+    SpectrumColourTable colourTable;
+
+    DisplayMode displayMode = DisplayMode::Spectrum;
+    SpectrogramView spectrogram;
+    juce::Image spectrogramGridLayer;
+    float spectrogramGridLayerScale = 1.0f;
+    int lastAnalysisFrame = 0;
+
+    ScopeCapture::Frame scopeFrame;
+    juce::RectangleList<float> scopeColumns;
+    bool scopeFrameFlat = false;
+
+    SpectrumGLRenderer glRenderer;
+    SpectrumGLRenderer::Vertices spectrumVertices, curveVertices;
+
+    // Cached layers: the grid only changes on resize, the curves when the running EQ moves
+    static constexpr const char* eqParameterIDs[] = { "lowShelfFreq", "lowShelfGain",
+                                                      "peak1Freq", "peak1Gain", "peak1Q",
+                                                      "peak3Freq", "peak3Gain", "peak3Q",
+                                                      "highShelfFreq", "highShelfGain" };
+    juce::Image gridLayer, curveLayer;
+    float gridLayerScale = 1.0f, curveLayerScale = 1.0f;
+    std::atomic<bool> curvesDirty { true };
+    int lastEQDisplayVersion = -1;
+    float lastSpectrumTop = 0.0f;
+    juce::Colour lastBrandColour;
+
+    // Adaptive rate state: bar heights (pixels) as last drawn, and when
+    static constexpr double staticFrameIntervalMs = 100.0; // 10fps while static or settling
+    std::vector<float> drawnLevels;
+    double lastFrameTime = 0.0;
+
+    // Declared last so the callback can never see a half-constructed component
+    juce::VBlankAttachment vBlankAttachment { this, [this]() { onVBlank(); } };
+
+    // Called from whichever thread changed the parameter (automation may arrive on the audio thread)
+    void parameterChanged(const juce::String&, float) override
+    {
+        curvesDirty = true;
+    }
+
+    juce::Rectangle<float> getPlotArea() const
+    {
+        return getLocalBounds().toFloat().reduced(15);
+    }
+
+    juce::Rectangle<float> getBrandArea(juce::Rectangle<float> bounds) const
+    {
+        return bounds.withSizeKeepingCentre(bounds.getWidth(), 140.0f);
+    }
+
+    // Renders a transparent full-size layer at the display's physical resolution
+    template <typename PaintFunction>
+    juce::Image renderLayer(float scale, float& layerScale, PaintFunction&& paintLayer)
+    {
+        layerScale = scale;
+
+        juce::Image layer(juce::Image::ARGB,
+                          juce::jmax(1, juce::roundToInt((float) getWidth() * scale)),
+                          juce::jmax(1, juce::roundToInt((float) getHeight() * scale)), true);
+        juce::Graphics lg(layer);
+        lg.addTransform(juce::AffineTransform::scale(scale));
+        paintLayer(lg);
+        return layer;
+    }
+
+    // Geometry and colours for one spectrum bin, shared by the software and GL paths
+    struct SpectrumBar
+    {
+        float x, y, peakY;
+        float scaledMag, scaledPeak;
+        juce::Colour glowColour, barColour, peakColour;
+    };
+
+    template <typename BarCallback>
+    void forEachSpectrumBar(juce::Rectangle<float> bounds, BarCallback&& drawBar)
+    {
+        auto binWidth = (float) (processor.getAnalysisSampleRate() / WorkstationProcessor::getFFTSize());
+
+        for (size_t i = 1; i < fftData.size() && i < peakHoldData.size() && i < (size_t) SpectrumColourTable::numPositions; ++i)
+        {
+            float freq = (float) i * binWidth;
+            if (freq < 30.0f || freq > 30000.0f) continue;
+            
+            SpectrumBar bar;
+            bar.x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
+            
+            bar.scaledMag = juce::jlimit(0.0f, 1.0f, fftData[i] * 2000.0f);
+            bar.scaledPeak = juce::jlimit(0.0f, 1.0f, peakHoldData[i] * 2000.0f);
+            
+            bar.y = bounds.getBottom() - bar.scaledMag * bounds.getHeight() * 0.85f;
+            bar.peakY = bounds.getBottom() - bar.scaledPeak * bounds.getHeight() * 0.85f;
+            
+            // Gradient colours come from the table built in generateRandomColours()
+            bar.glowColour = colourTable.getGlowColour((int) i, bar.scaledMag);
+            bar.barColour = colourTable.getBarColour((int) i, bar.scaledMag);
+            bar.peakColour = colourTable.getPeakColour((int) i, bar.scaledPeak);
+            
+            drawBar(bar);
+        }
+    }
+
+    // Highest pixel row touched by the bars, peak markers and sparkles this frame.
+    // Bins under half a pixel draw nothing, so a decaying tail reads as empty.
+    float findSpectrumTop(juce::Rectangle<float> bounds) const
+    {
+        auto top = bounds.getBottom();
+
+        for (size_t i = 1; i < fftData.size() && i < peakHoldData.size() && i < (size_t) SpectrumColourTable::numPositions; ++i)
+        {
+            auto level = juce::jlimit(0.0f, 1.0f, std::max(fftData[i], peakHoldData[i]) * 2000.0f);
+            auto height = level * bounds.getHeight() * 0.85f;
+            if (height >= 0.5f)
+                top = std::min(top, bounds.getBottom() - height - 3.0f);
+        }
+
+        return top;
+    }
+
+    // Largest change in pixels of any bar or peak marker since the last drawn frame
+    float measureSpectrumMotion(juce::Rectangle<float> bounds)
+    {
+        auto numBins = std::min({ fftData.size(), peakHoldData.size(), (size_t) SpectrumColourTable::numPositions });
+        drawnLevels.resize(numBins * 2, 0.0f);
+
+        float motion = 0.0f;
+
+        for (size_t i = 1; i < numBins; ++i)
+        {
+            auto barHeight = juce::jlimit(0.0f, 1.0f, fftData[i] * 2000.0f) * bounds.getHeight() * 0.85f;
+            auto peakHeight = juce::jlimit(0.0f, 1.0f, peakHoldData[i] * 2000.0f) * bounds.getHeight() * 0.85f;
+
+            motion = std::max({ motion, std::abs(barHeight - drawnLevels[i * 2]),
+                                std::abs(peakHeight - drawnLevels[i * 2 + 1]) });
+        }
+
+        return motion;
+    }
+
+    // Records the bar heights being drawn, as the reference for measureSpectrumMotion
+    void storeDrawnLevels(juce::Rectangle<float> bounds)
+    {
+        auto numBins = std::min({ fftData.size(), peakHoldData.size(), (size_t) SpectrumColourTable::numPositions });
+        drawnLevels.resize(numBins * 2, 0.0f);
+
+        for (size_t i = 1; i < numBins; ++i)
+        {
+            drawnLevels[i * 2] = juce::jlimit(0.0f, 1.0f, fftData[i] * 2000.0f) * bounds.getHeight() * 0.85f;
+            drawnLevels[i * 2 + 1] = juce::jlimit(0.0f, 1.0f, peakHoldData[i] * 2000.0f) * bounds.getHeight() * 0.85f;
+        }
+    }
+
+    // Visits the visible points of a dB response curve (centre line = 0dB, ±24dB range)
+    template <typename PointCallback>
+    void forEachCurvePoint(const std::vector<float>& response, juce::Rectangle<float> bounds, PointCallback&& addPoint)
+    {
+        bool first = true;
         
-        if (!fftData.empty() && !peakHoldData.empty())
+        for (size_t i = 0; i < frequencies.size() && i < response.size(); ++i)
         {
+            float freq = frequencies[i];
+            if (freq < 30.0f || freq > 18000.0f) continue;
             
-            // Spectrum bars - main colorful display
-            for (size_t i = 1; i < fftData.size() && i < 300; ++i)
+            auto x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
+            
+            float normalizedGain = (response[i] + 24.0f) / 48.0f; // Map -24dB to +24dB into 0-1 range
+            normalizedGain = juce::jlimit(0.0f, 1.0f, normalizedGain);
+            
+            addPoint(x, bounds.getBottom() - (normalizedGain * bounds.getHeight()), first);
+            first = false;
+        }
+    }
+
+    // Recomputes the EQ responses and invalidates both curve caches
+    void updateCurves(juce::Rectangle<float> bounds)
+    {
+        processor.getFrequencyResponse(frequencies, magnitudes);
+        processor.getIndividualBandResponses(frequencies, lowShelfResponse, peak1Response, 
+                                           peak3Response, highShelfResponse);
+        curveLayer = {};
+
+        curveVertices.clear();
+        auto addCurve = [&](const std::vector<float>& response, juce::Colour colour, float thickness)
+        {
+            float lastX = 0.0f, lastY = 0.0f;
+            forEachCurvePoint(response, bounds, [&](float x, float y, bool first)
             {
-                float freq = (float)i * (22050.0f / 512.0f);
-                if (freq < 30.0f || freq > 30000.0f) continue;
-                
-                auto x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
-                
-                float magnitude = fftData[i];
-                float peakMagnitude = peakHoldData[i];
-                
-                float scaledMag = juce::jlimit(0.0f, 1.0f, magnitude * 2000.0f);
-                float scaledPeak = juce::jlimit(0.0f, 1.0f, peakMagnitude * 2000.0f);
-                
-                auto height = scaledMag * bounds.getHeight() * 0.85f;
-                auto peakHeight = scaledPeak * bounds.getHeight() * 0.85f;
-                auto y = bounds.getBottom() - height;
-                auto peakY = bounds.getBottom() - peakHeight;
-                
-                // Simple two-colour gradient based on frequency position
-                float freqPosition = (float)i / 300.0f; // Position in spectrum (0.0 to 1.0)
-                
-                // Interpolate between the two base hues
-                float hue = baseHue1 + (baseHue2 - baseHue1) * freqPosition;
-                
-                // Enhanced spectrum with glow effect 🌟
-                // Background glow for stronger signals
-                if (scaledMag > 0.3f)
-                {
-                    g.setColour(juce::Colour::fromHSV(hue, 0.6f, 0.4f + scaledMag * 0.3f, 0.3f));
-                    g.drawLine(x, bounds.getBottom(), x, y, 6.0f); // Wider glow
-                }
+                if (! first)
+                    SpectrumGLRenderer::addLine(curveVertices, lastX, lastY, x, y, thickness, colour);
                 
-                // Main spectrum bar with enhanced brightness dynamics
-                float dynamicSaturation = 0.7f + scaledMag * 0.3f; // More vivid at higher levels
-                float dynamicBrightness = 0.5f + scaledMag * 0.5f; // Brighter at higher levels
-                g.setColour(juce::Colour::fromHSV(hue, dynamicSaturation, dynamicBrightness, 0.85f));
-                g.drawLine(x, bounds.getBottom(), x, y, 3.0f);
-                
-                // Enhanced peak hold with sparkle effect
-                if (scaledPeak > 0.01f)
-                {
-                    // Bright peak indicator
-                    g.setColour(juce::Colour::fromHSV(hue, 0.9f, 0.9f + scaledPeak * 0.1f, 0.95f));
-                    g.drawLine(x, peakY - 1, x, peakY + 1, 2.5f);
-                    
-                    // Add sparkle for very high peaks
-                    if (scaledPeak > 0.7f)
-                    {
-                        g.setColour(juce::Colours::white.withAlpha(0.8f));
-                        g.fillEllipse(x - 1, peakY - 1, 2, 2); // Sparkle dot
-                    }
-                }
+                lastX = x;
+                lastY = y;
+            });
+        };
+
+        addCurve(magnitudes, juce::Colours::white.withAlpha(0.9f), 2.5f);
+        addCurve(lowShelfResponse, juce::Colours::red.withAlpha(0.7f), 1.8f);
+        addCurve(peak1Response, juce::Colours::orange.withAlpha(0.7f), 1.8f);
+        addCurve(peak3Response, juce::Colours::lightblue.withAlpha(0.7f), 1.8f);
+        addCurve(highShelfResponse, juce::Colours::cyan.withAlpha(0.7f), 1.8f);
+    }
+
+    void paintSpectrumBars(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        // Spectrum bars - main colorful display
+        forEachSpectrumBar(bounds, [&](const SpectrumBar& bar)
+        {
+            if (bar.scaledMag > 0.3f)
+            {
+                g.setColour(bar.glowColour);
+                g.drawLine(bar.x, bounds.getBottom(), bar.x, bar.y, 6.0f); // Wider glow
             }
             
-            // Draw EQ response curve overlay
-            processor.getFrequencyResponse(frequencies, magnitudes);
-            if (!frequencies.empty() && !magnitudes.empty())
+            g.setColour(bar.barColour);
+            g.drawLine(bar.x, bounds.getBottom(), bar.x, bar.y, 3.0f);
+            
+            // Enhanced peak hold with sparkle effect
+            if (bar.scaledPeak > 0.01f)
             {
-                juce::Path eqCurvePath;
-                bool pathStarted = false;
+                g.setColour(bar.peakColour);
+                g.drawLine(bar.x, bar.peakY - 1, bar.x, bar.peakY + 1, 2.5f);
                 
-                for (size_t i = 0; i < frequencies.size(); ++i)
+                // Add sparkle for very high peaks
+                if (bar.scaledPeak > 0.7f)
                 {
-                    float freq = frequencies[i];
-                    if (freq < 30.0f || freq > 18000.0f) continue;
-                    
-                    auto x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
-                    
-                    // Convert dB to visual position (centre line = 0dB, ±24dB range)
-                    float gainDb = magnitudes[i];
-                    float normalizedGain = (gainDb + 24.0f) / 48.0f; // Map -24dB to +24dB into 0-1 range
-                    normalizedGain = juce::jlimit(0.0f, 1.0f, normalizedGain);
-                    
-                    auto y = bounds.getBottom() - (normalizedGain * bounds.getHeight());
-                    
-                    if (!pathStarted)
-                    {
-                        eqCurvePath.startNewSubPath(x, y);
-                        pathStarted = true;
-                    }
-                    else
-                    {
-                        eqCurvePath.lineTo(x, y);
-                    }
+                    g.setColour(juce::Colours::white.withAlpha(0.8f));
+                    g.fillEllipse(bar.x - 1, bar.peakY - 1, 2, 2); // Sparkle dot
                 }
-                
-                // Draw EQ curve as bright white line
-                g.setColour(juce::Colours::white.withAlpha(0.9f));
-                g.strokePath(eqCurvePath, juce::PathStrokeType(2.5f));
-                
-                // Draw centre reference line (0dB)
-                float centreY = bounds.getCentreY();
-                g.setColour(juce::Colours::white.withAlpha(0.3f));
-                g.drawLine(bounds.getX(), centreY, bounds.getRight(), centreY, 1.0f);
             }
-            
-            // REVOLUTIONARY MULTI-COLORED EQ VISUALIZATION! 🎨
-            processor.getIndividualBandResponses(frequencies, lowShelfResponse, peak1Response, 
-                                               peak3Response, highShelfResponse);
-            if (!frequencies.empty() && !lowShelfResponse.empty())
+        });
+    }
+
+    void paintCurves(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        auto strokeCurve = [&](const std::vector<float>& response, juce::Colour colour, float thickness)
+        {
+            juce::Path curvePath;
+            forEachCurvePoint(response, bounds, [&](float x, float y, bool first)
             {
-                // Individual colored band responses
-                auto drawBandResponse = [&](const std::vector<float>& response, juce::Colour color) {
-                    juce::Path bandPath;
-                    bool pathStarted = false;
-                    
-                    for (size_t i = 0; i < frequencies.size(); ++i)
-                    {
-                        float freq = frequencies[i];
-                        if (freq < 30.0f || freq > 18000.0f) continue;
-                        
-                        auto x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
-                        
-                        // Convert dB to visual position
-                        float gainDb = response[i];
-                        float normalizedGain = (gainDb + 24.0f) / 48.0f;
-                        normalizedGain = juce::jlimit(0.0f, 1.0f, normalizedGain);
-                        
-                        auto y = bounds.getBottom() - (normalizedGain * bounds.getHeight());
-                        
-                        if (!pathStarted)
-                        {
-                            bandPath.startNewSubPath(x, y);
-                            pathStarted = true;
-                        }
-                        else
-                        {
-                            bandPath.lineTo(x, y);
-                        }
-                    }
-                    
-                    // Draw colored band response
-                    g.setColour(color.withAlpha(0.7f));
-                    g.strokePath(bandPath, juce::PathStrokeType(1.8f));
-                };
-                
-                // Draw each EQ band in its signature color
-                drawBandResponse(lowShelfResponse, juce::Colours::red);           // Red: Low Shelf
-                drawBandResponse(peak1Response, juce::Colours::orange);          // Orange: Peak 1  
-                drawBandResponse(peak3Response, juce::Colours::lightblue);       // Light Blue: Peak 3
-                drawBandResponse(highShelfResponse, juce::Colours::cyan);        // Cyan: High Shelf
-            }
+                if (first)
+                    curvePath.startNewSubPath(x, y);
+                else
+                    curvePath.lineTo(x, y);
+            });
+            
+            g.setColour(colour);
+            g.strokePath(curvePath, juce::PathStrokeType(thickness));
+        };
+        
+        // Combined EQ response as a bright white line, then each band in its signature colour
+        strokeCurve(magnitudes, juce::Colours::white.withAlpha(0.9f), 2.5f);
+        strokeCurve(lowShelfResponse, juce::Colours::red.withAlpha(0.7f), 1.8f);           // Red: Low Shelf
+        strokeCurve(peak1Response, juce::Colours::orange.withAlpha(0.7f), 1.8f);          // Orange: Peak 1
+        strokeCurve(peak3Response, juce::Colours::lightblue.withAlpha(0.7f), 1.8f);       // Light Blue: Peak 3
+        strokeCurve(highShelfResponse, juce::Colours::cyan.withAlpha(0.7f), 1.8f);        // Cyan: High Shelf
+    }
+
+    // Same bars as paintSpectrumBars plus the cached curves, as one triangle list for the GL layer
+    void buildSpectrumVertices(juce::Rectangle<float> bounds)
+    {
+        using GL = SpectrumGLRenderer;
+        
+        spectrumVertices.clear();
+        
+        forEachSpectrumBar(bounds, [&](const SpectrumBar& bar)
+        {
+            if (bar.scaledMag > 0.3f)
+                GL::addLine(spectrumVertices, bar.x, bounds.getBottom(), bar.x, bar.y, 6.0f, bar.glowColour);
             
-            // Draw professional grid
-            g.setFont(juce::FontOptions(12.0f));
+            GL::addLine(spectrumVertices, bar.x, bounds.getBottom(), bar.x, bar.y, 3.0f, bar.barColour);
             
-            // Major frequency lines with labels (logarithmically spaced)
-            g.setColour(juce::Colours::darkgrey.withAlpha(0.6f));
-            for (float freq : {50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000})
+            if (bar.scaledPeak > 0.01f)
             {
-                if (freq >= 30.0f && freq <= 30000.0f)
-                {
-                    auto x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
-                    g.drawLine(x, bounds.getY(), x, bounds.getBottom(), 1.0f);
-                    
-                    // Frequency labels
-                    juce::String label = freq >= 1000.0f ? juce::String(freq / 1000.0f, 1) + "k" : juce::String((int)freq);
-                    g.setColour(juce::Colours::lightgrey);
-                    g.drawText(label, x - 15, bounds.getBottom() + 5, 30, 15, juce::Justification::centred);
-                    g.setColour(juce::Colours::darkgrey.withAlpha(0.6f)); // Reset color for next line
-                }
+                GL::addLine(spectrumVertices, bar.x, bar.peakY - 1, bar.x, bar.peakY + 1, 2.5f, bar.peakColour);
+                
+                if (bar.scaledPeak > 0.7f)
+                    GL::addRectangle(spectrumVertices, { bar.x - 1, bar.peakY - 1, 2, 2 }, juce::Colours::white.withAlpha(0.8f));
             }
-            
-            // Level grid lines
-            g.setColour(juce::Colours::darkgrey.withAlpha(0.3f));
-            for (int i = 1; i < 5; ++i)
+        });
+        
+        spectrumVertices.insert(spectrumVertices.end(), curveVertices.begin(), curveVertices.end());
+    }
+
+    void paintGrid(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        // Draw professional grid
+        g.setFont(juce::FontOptions(12.0f));
+        
+        // Major frequency lines with labels (logarithmically spaced)
+        g.setColour(juce::Colours::darkgrey.withAlpha(0.6f));
+        for (float freq : {50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000})
+        {
+            if (freq >= 30.0f && freq <= 30000.0f)
             {
-                auto y = bounds.getY() + (bounds.getHeight() * i / 5);
-                g.drawLine(bounds.getX(), y, bounds.getRight(), y, 1.0f);
+                auto x = juce::mapFromLog10(freq, 30.0f, 30000.0f) * bounds.getWidth() + bounds.getX();
+                g.drawLine(x, bounds.getY(), x, bounds.getBottom(), 1.0f);
+                
+                // Frequency labels
+                juce::String label = freq >= 1000.0f ? juce::String(freq / 1000.0f, 1) + "k" : juce::String((int)freq);
+                g.setColour(juce::Colours::lightgrey);
+                g.drawText(label, x - 15, bounds.getBottom() + 5, 30, 15, juce::Justification::centred);
+                g.setColour(juce::Colours::darkgrey.withAlpha(0.6f)); // Reset color for next line
             }
         }
         
-        // Konda by Turbeaux Sounds - Audio-Reactive Branding
-        processor.getFFTData(fftData);
+        // Level grid lines
+        g.setColour(juce::Colours::darkgrey.withAlpha(0.3f));
+        for (int i = 1; i < 5; ++i)
+        {
+            auto y = bounds.getY() + (bounds.getHeight() * i / 5);
+            g.drawLine(bounds.getX(), y, bounds.getRight(), y, 1.0f);
+        }
+        
+        // Centre reference line (0dB)
+        g.setColour(juce::Colours::white.withAlpha(0.3f));
+        g.drawLine(bounds.getX(), bounds.getCentreY(), bounds.getRight(), bounds.getCentreY(), 1.0f);
+    }
+
+    // One min/max bar per pixel column: O(width) whatever the sweep length
+    void paintScope(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        auto numColumns = scopeFrame.numColumnsUsed;
+        auto width = (int) bounds.getWidth();
+
+        if (numColumns <= 0 || width <= 0)
+            return;
+
+        auto halfHeight = bounds.getHeight() * 0.45f;
+        scopeColumns.clear();
+
+        for (int x = 0; x < width; ++x)
+        {
+            auto first = x * numColumns / width;
+            auto last = juce::jmax(first + 1, (x + 1) * numColumns / width);
+
+            auto minimum = scopeFrame.minimum[(size_t) first];
+            auto maximum = scopeFrame.maximum[(size_t) first];
+            for (int column = first + 1; column < last; ++column)
+            {
+                minimum = juce::jmin(minimum, scopeFrame.minimum[(size_t) column]);
+                maximum = juce::jmax(maximum, scopeFrame.maximum[(size_t) column]);
+            }
+
+            auto top = bounds.getCentreY() - juce::jlimit(-1.0f, 1.0f, maximum) * halfHeight;
+            auto bottom = bounds.getCentreY() - juce::jlimit(-1.0f, 1.0f, minimum) * halfHeight;
+            scopeColumns.addWithoutMerging({ bounds.getX() + (float) x, top, 1.0f, juce::jmax(1.0f, bottom - top) });
+        }
+
+        // Dimmed while free-running (nothing to trigger on)
+        g.setColour(juce::Colour::fromHSV(baseHue1, 0.6f, 1.0f, scopeFrame.triggered ? 0.9f : 0.5f));
+        g.fillRectList(scopeColumns);
+    }
+
+    void paintScopeGrid(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        g.setColour(juce::Colours::darkgrey.withAlpha(0.3f));
+        for (int i = 1; i < 8; ++i)
+        {
+            auto x = bounds.getX() + (bounds.getWidth() * i / 8);
+            g.drawLine(x, bounds.getY(), x, bounds.getBottom(), 1.0f);
+        }
+
+        g.setColour(juce::Colours::white.withAlpha(0.3f));
+        g.drawLine(bounds.getX(), bounds.getCentreY(), bounds.getRight(), bounds.getCentreY(), 1.0f);
+    }
+
+    // Horizontal frequency lines for the waterfall, labelled on the left
+    void paintSpectrogramGrid(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        g.setFont(juce::FontOptions(12.0f));
+
+        for (float freq : {50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000})
+        {
+            if (freq >= spectrogram.getNyquist())
+                break;
+
+            auto y = spectrogram.getYForFrequency(freq, bounds);
+
+            g.setColour(juce::Colours::darkgrey.withAlpha(0.5f));
+            g.drawLine(bounds.getX(), y, bounds.getRight(), y, 1.0f);
+
+            juce::String label = freq >= 1000.0f ? juce::String(freq / 1000.0f, 1) + "k" : juce::String((int)freq);
+            g.setColour(juce::Colours::lightgrey);
+            g.drawText(label, (int) bounds.getX() + 4, (int) y - 14, 40, 12, juce::Justification::centredLeft);
+        }
+    }
+
+    // Konda by Turbeaux Sounds - Audio-Reactive Branding
+    juce::Colour getBrandColour() const
+    {
         float audioLevel = 0.0f;
         if (!fftData.empty())
         {
@@ -238,31 +757,122 @@ public:
         
         // Add subtle color tint based on current hue
         float tintAmount = audioLevel * 0.15f; // Subtle color influence
-        juce::Colour brandColor = juce::Colours::white.withAlpha(pulseAlpha);
         if (tintAmount > 0.05f)
-        {
-            brandColor = juce::Colour::fromHSV(baseHue1, tintAmount, 1.0f, pulseAlpha);
-        }
-        
-        g.setColour(brandColor);
+            return juce::Colour::fromHSV(baseHue1, tintAmount, 1.0f, pulseAlpha);
+
+        return juce::Colours::white.withAlpha(pulseAlpha);
+    }
+
+    void paintBranding(juce::Graphics& g, juce::Rectangle<float> bounds)
+    {
+        g.setColour(getBrandColour());
         g.setFont(juce::FontOptions(108.0f).withStyle("bold"));
         g.drawText("KONDA", bounds, juce::Justification::centred);
     }
-    
+};
+
+class LevelMeterComponent : public juce::Component, public juce::Timer
+{
+public:
+    LevelMeterComponent(WorkstationProcessor& p) : processor(p)
+    {
+        startTimerHz(30);
+    }
+
+    // Click to restart the integrated loudness measurement
+    void mouseDown(const juce::MouseEvent&) override
+    {
+        processor.resetIntegratedLoudness();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colours::black);
+
+        auto bounds = getLocalBounds().reduced(4);
+        auto textArea = bounds.removeFromBottom(78);
+        auto correlationArea = bounds.removeFromBottom(14);
+        bounds.removeFromBottom(4);
+
+        // L / R bars: RMS fill, sample peak line, true-peak tick
+        auto barWidth = (bounds.getWidth() - 6) / 2;
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto bar = bounds.removeFromLeft(barWidth).toFloat();
+            bounds.removeFromLeft(6);
+
+            g.setColour(juce::Colours::darkgrey.withAlpha(0.4f));
+            g.fillRect(bar);
+
+            auto rmsY = dbToY(readings.rmsDb[(size_t) channel], bar);
+            g.setColour(juce::Colours::lightgreen);
+            g.fillRect(bar.withTop(rmsY));
+
+            g.setColour(juce::Colours::white);
+            g.drawHorizontalLine((int) dbToY(readings.peakDb[(size_t) channel], bar), bar.getX(), bar.getRight());
+
+            // True-peak turns red above -1 dBTP, the usual delivery ceiling
+            auto truePeak = readings.truePeakDb[(size_t) channel];
+            g.setColour(truePeak > -1.0f ? juce::Colours::red : juce::Colours::orange);
+            g.fillRect(bar.getX(), dbToY(truePeak, bar) - 1.0f, bar.getWidth(), 2.0f);
+        }
+
+        // Correlation: -1 (left) .. +1 (right), centre line at 0
+        auto correlation = correlationArea.toFloat();
+        g.setColour(juce::Colours::darkgrey.withAlpha(0.4f));
+        g.fillRect(correlation);
+        g.setColour(juce::Colours::white.withAlpha(0.3f));
+        g.drawVerticalLine((int) correlation.getCentreX(), correlation.getY(), correlation.getBottom());
+
+        auto markerX = correlation.getCentreX() + readings.correlation * correlation.getWidth() * 0.5f;
+        g.setColour(readings.correlation < 0.0f ? juce::Colours::red : juce::Colours::cyan);
+        g.fillRect(markerX - 2.0f, correlation.getY(), 4.0f, correlation.getHeight());
+
+        // Loudness readouts
+        g.setFont(juce::FontOptions(11.0f));
+        g.setColour(juce::Colours::lightgrey);
+
+        auto addLine = [&](const juce::String& label, float value, const juce::String& unit)
+        {
+            auto line = textArea.removeFromTop(13);
+            g.drawText(label, line.removeFromLeft(22), juce::Justification::centredLeft);
+            g.drawText(value <= -99.0f ? juce::String("-inf") : juce::String(value, 1) + unit,
+                       line, juce::Justification::centredRight);
+        };
+
+        addLine("M", readings.momentaryLufs, "");
+        addLine("S", readings.shortTermLufs, "");
+        addLine("I", readings.integratedLufs, " LUFS");
+        addLine("TP", readings.truePeakMaxDb, " dBTP");
+        addLine("Mid", readings.midRmsDb, " dB");
+        addLine("Side", readings.sideRmsDb, " dB");
+    }
+
     void timerCallback() override
     {
-        repaint();
+        auto newReadings = processor.getMeterReadings();
+
+        // Nothing moves once the output has been silent for a while
+        if (std::memcmp(&newReadings, &readings, sizeof(readings)) != 0)
+        {
+            readings = newReadings;
+            repaint();
+        }
     }
-    
+
 private:
     WorkstationProcessor& processor;
-    std::vector<float> frequencies, magnitudes;
-    std::vector<float> waveformData, fftData, peakHoldData;
-    std::vector<float> lowShelfResponse, peak1Response, peak3Response, highShelfResponse;
-    float baseHue1, baseHue2;
+    MeteringEngine::Readings readings;
+
+    // -60dB at the bottom to +3dB at the top
+    static float dbToY(float db, juce::Rectangle<float> area)
+    {
+        auto proportion = juce::jlimit(0.0f, 1.0f, (db + 60.0f) / 63.0f);
+        return area.getBottom() - proportion * area.getHeight();
+    }
 };
 
-class MIDIPatternComponent : public juce::Component
+class MIDIPatternComponent : public juce::Component, private juce::Timer
 {
 public:
     MIDIPatternComponent(WorkstationProcessor& p) : processor(p)
@@ -316,30 +926,17 @@ public:
             addAndMakeVisible(keyDisplayLabel);
         }
 
-        // Mode selector
-        modeSelector.addItem("Major", 1);
-        modeSelector.addItem("Minor", 2);
-        modeSelector.addItem("Dorian", 3);
-        modeSelector.addItem("Phrygian", 4);
-        modeSelector.addItem("Lydian", 5);
-        modeSelector.addItem("Mixolydian", 6);
-        modeSelector.addItem("Locrian", 7);
-        modeSelector.setSelectedId(1); // Major
+        // Mode and pattern selectors, filled from the pattern library
         modeSelector.onChange = [this] {
             processor.setMode(modeSelector.getSelectedId() - 1);
         };
 
-        // Pattern selector
-        patternSelector.addItem("Scale", 1);
-        patternSelector.addItem("Arpeggios", 2);
-        patternSelector.addItem("Chord Tones", 3);
-        patternSelector.addItem("Step Pattern", 4);
-        patternSelector.addItem("Cascading", 5);
-        patternSelector.setSelectedId(1); // Scale
         patternSelector.onChange = [this] {
             processor.setMelodyPattern(patternSelector.getSelectedId() - 1);
         };
 
+        refreshPatternLists();
+
         // Only add selectors in standalone mode
         if (isStandalone) {
             addAndMakeVisible(modeSelector);
@@ -349,7 +946,41 @@ public:
         keyDisplayLabel.setText("C", juce::dontSendNotification);
         keyDisplayLabel.setJustificationType(juce::Justification::centred);
         keyDisplayLabel.setFont(juce::FontOptions(14.0f).withStyle("bold"));
-        
+
+        // Offline render of the current key/mode/pattern for arrangement tools
+        exportButton.setButtonText("Export");
+        exportButton.setTooltip("Save 8 bars of the pattern as a MIDI file");
+        exportButton.onClick = [this] { chooseExportFile(); };
+        addAndMakeVisible(exportButton);
+
+        // Percussion lane on/off; the other lanes are set up in the pattern file
+        drumsButton.setButtonText("Drums");
+        drumsButton.setClickingTogglesState(true);
+        drumsButton.onClick = [this] {
+            auto settings = processor.getLaneSettings(StepSequencer::percussionLane);
+            settings.enabled = drumsButton.getToggleState();
+            processor.setLaneSettings(StepSequencer::percussionLane, settings);
+        };
+        addAndMakeVisible(drumsButton);
+
+        // Edits to the pattern file are picked up while it's open in a text editor
+        libraryModified = processor.getPatternLibraryFile().getLastModificationTime();
+        startTimer(1000);
+    }
+
+    void refreshPatternLists()
+    {
+        auto fill = [](juce::ComboBox& selector, const juce::StringArray& names, int selectedIndex)
+        {
+            selector.clear(juce::dontSendNotification);
+            for (int i = 0; i < names.size(); ++i)
+                selector.addItem(names[i], i + 1);
+            selector.setSelectedId(selectedIndex + 1, juce::dontSendNotification);
+        };
+
+        fill(modeSelector, processor.getModeNames(), processor.getMode());
+        fill(patternSelector, processor.getMelodyPatternNames(), processor.getMelodyPattern());
+        drumsButton.setToggleState(processor.getLaneSettings(StepSequencer::percussionLane).enabled, juce::dontSendNotification);
     }
     
     void updateKeyDisplay()
@@ -391,6 +1022,9 @@ public:
         if (playStopButton.isVisible()) {
             playStopButton.setBounds(controlRow.removeFromRight(70).reduced(2));
         }
+
+        exportButton.setBounds(controlRow.removeFromRight(70).reduced(2));
+        drumsButton.setBounds(controlRow.removeFromRight(70).reduced(2));
     }
     
     void setOnPlayCallback(std::function<void()> callback)
@@ -410,13 +1044,13 @@ public:
         int currentMode = modeSelector.getSelectedId();
         int newMode;
         do {
-            newMode = 1 + juce::Random::getSystemRandom().nextInt(7);
+            newMode = 1 + juce::Random::getSystemRandom().nextInt(modeSelector.getNumItems());
         } while (newMode == currentMode && juce::Random::getSystemRandom().nextFloat() < 0.7f); // 70% chance to pick different mode
 
         int currentPattern = patternSelector.getSelectedId();
         int newPattern;
         do {
-            newPattern = 1 + juce::Random::getSystemRandom().nextInt(5);
+            newPattern = 1 + juce::Random::getSystemRandom().nextInt(patternSelector.getNumItems());
         } while (newPattern == currentPattern && juce::Random::getSystemRandom().nextFloat() < 0.8f); // 80% chance to pick different pattern
 
         modeSelector.setSelectedId(newMode);
@@ -428,13 +1062,59 @@ public:
     }
     
 private:
+    void timerCallback() override
+    {
+        auto modified = processor.getPatternLibraryFile().getLastModificationTime();
+        if (modified == libraryModified)
+            return;
+
+        libraryModified = modified;
+
+        juce::String error;
+        if (processor.reloadPatternLibrary(error))
+        {
+            refreshPatternLists();
+            patternSelector.setTooltip({});
+        }
+        else
+        {
+            // Keep playing the last good library and show why the edit didn't apply
+            patternSelector.setTooltip("Pattern file not loaded: " + error);
+        }
+    }
+
+    static constexpr int exportSteps = 64; // 8 bars of eighth notes
+    static constexpr double exportBpm = 120.0; // The standalone playback tempo
+
+    void chooseExportFile()
+    {
+        exportChooser = std::make_unique<juce::FileChooser>(
+            "Export pattern", juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("Konda Pattern.mid"), "*.mid");
+
+        auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting;
+
+        exportChooser->launchAsync(flags, [this](const juce::FileChooser& chooser)
+        {
+            auto file = chooser.getResult();
+            if (file == juce::File())
+                return;
+
+            if (!processor.exportPatternToMidiFile(file.withFileExtension("mid"), exportSteps, exportBpm))
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Export failed",
+                                                       "Couldn't write " + file.getFullPathName());
+        });
+    }
+
     WorkstationProcessor& processor;
     juce::TextButton playStopButton;
     juce::TextButton keyUpButton, keyDownButton;
+    juce::TextButton exportButton, drumsButton;
     juce::Label keyDisplayLabel;
     juce::ComboBox modeSelector, patternSelector;
     int currentKey;
     std::function<void()> onPlayCallback;
+    std::unique_ptr<juce::FileChooser> exportChooser;
+    juce::Time libraryModified;
 };
 
 class WorkstationEditor : public juce::AudioProcessorEditor
@@ -450,6 +1130,9 @@ public:
     void randomizeEQ();
     void randomizeReverb();
     void refreshMidiDevices();
+    void chooseImpulseResponse();
+    void refreshPresetList();
+    void updateMorphSnapshotButtons();
 
 private:
     WorkstationProcessor& processor;
@@ -465,9 +1148,22 @@ private:
     juce::Label waveformLabel, filterTypeLabel, lfoWaveformLabel;
     juce::Slider lfoRateSlider, lfoDepthSlider;
     juce::Label lfoRateLabel, lfoDepthLabel;
+    juce::Slider unisonVoicesSlider, unisonDetuneSlider, unisonSpreadSlider;
+    juce::Label unisonVoicesLabel, unisonDetuneLabel, unisonSpreadLabel;
+    juce::Slider multiCoreVoicesSlider;
+    juce::Label multiCoreLabel;
+    juce::ToggleButton multiCoreButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> multiCoreAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveformAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterTypeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lfoWaveformAttachment;
+
+    // Oversampling controls
+    juce::ComboBox oversamplingSelector;
+    juce::Label oversamplingLabel;
+    juce::ToggleButton renderHighQualityButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> renderHighQualityAttachment;
     
     // EQ controls
     juce::Slider lowShelfFreqSlider, lowShelfGainSlider;
@@ -481,17 +1177,43 @@ private:
     // Reverb controls
     juce::Slider reverbRoomSizeSlider, reverbDampingSlider, reverbWetLevelSlider, reverbDryLevelSlider;
     juce::Label reverbRoomSizeLabel, reverbDampingLabel, reverbWetLevelLabel, reverbDryLevelLabel;
+    juce::ComboBox reverbModeSelector;
+    juce::TextButton loadImpulseResponseButton;
+    std::unique_ptr<juce::FileChooser> impulseResponseChooser;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> reverbModeAttachment;
+
+    // Snapshot morph
+    juce::Label morphLabel;
+    juce::Slider morphSlider;
+    std::array<juce::TextButton, WorkstationProcessor::numMorphSnapshots> morphSnapshotButtons;
     
     
     // Visualizer and MIDI
     std::unique_ptr<EQVisualizerComponent> eqVisualizer;
+    std::unique_ptr<LevelMeterComponent> levelMeter;
     std::unique_ptr<MIDIPatternComponent> midiPattern;
+    juce::ToggleButton gpuSpectrumButton;
+    juce::ComboBox displayModeSelector;
+
+    // Preset library
+    juce::ComboBox presetSelector;
+    juce::TextButton savePresetButton;
     
     // MIDI device selection
     juce::ComboBox midiDeviceSelector;
     juce::Label midiDeviceLabel;
     juce::TextButton refreshMidiButton;
 
+    // Live MIDI stage: arpeggiator, chord memory and scale quantise
+    juce::Label liveLabel;
+    juce::ComboBox arpModeSelector, arpRateSelector;
+    juce::Slider arpOctavesSlider, arpGateSlider;
+    juce::ToggleButton chordMemoryButton, scaleQuantiseButton, mpeButton;
+    juce::TextButton learnChordButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> arpModeAttachment, arpRateAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> arpOctavesAttachment, arpGateAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> chordMemoryAttachment, scaleQuantiseAttachment, mpeAttachment;
+
     // Octave selection
     juce::Label octaveLabel;
     juce::ToggleButton octave2Button, octave3Button, octave4Button, octave5Button, octave6Button;
@@ -1,5 +1,25 @@
 #include "WorkstationProcessor.h"
 #include "WorkstationEditor.h"
+#include "MidiFileIO.h"
+
+namespace
+{
+    // Parameter IDs for WorkstationProcessor::MorphTarget, in enum order
+    const char* const morphTargetIDs[] =
+    {
+        "attack", "decay", "sustain", "release",
+        "filterCutoff", "filterResonance", "distortion", "lfoRate", "lfoDepth",
+        "lowShelfFreq", "lowShelfGain", "peak1Freq", "peak1Gain", "peak1Q",
+        "peak3Freq", "peak3Gain", "peak3Q", "highShelfFreq", "highShelfGain",
+        "reverbRoomSize", "reverbDamping", "reverbWetLevel", "reverbDryLevel"
+    };
+
+    // Frequencies and rates morph geometrically so sweeps sound even across octaves
+    bool isLogarithmicMorphTarget(const juce::String& id)
+    {
+        return id.endsWith("Freq") || id == "filterCutoff" || id == "lfoRate";
+    }
+}
 
 WorkstationProcessor::WorkstationProcessor()
     : AudioProcessor(BusesProperties()
@@ -16,6 +36,12 @@ WorkstationProcessor::WorkstationProcessor()
           std::make_unique<juce::AudioParameterFloat>("filterResonance", "Filter Resonance", 0.1f, 5.0f, 0.5f),
           std::make_unique<juce::AudioParameterFloat>("distortion", "Distortion", 1.0f, 10.0f, 1.0f),
 
+          // Oversampling for the synth + distortion section
+          std::make_unique<juce::AudioParameterChoice>("oversampling", "Oversampling",
+                                                      juce::StringArray{"1x", "2x", "4x", "8x"}, 0),
+          // 8x oversampling for bounces. Off by default: while on, live monitoring is padded to the 8x render latency
+          std::make_unique<juce::AudioParameterBool>("renderHighQuality", "Render High Quality", false),
+
           // New synthesis parameters
           std::make_unique<juce::AudioParameterChoice>("waveform", "Waveform",
                                                       juce::StringArray{"Sine", "Sawtooth", "Square", "Triangle"}, 0),
@@ -26,9 +52,31 @@ WorkstationProcessor::WorkstationProcessor()
           std::make_unique<juce::AudioParameterChoice>("lfoWaveform", "LFO Waveform",
                                                       juce::StringArray{"Sine", "Sawtooth", "Square", "Triangle"}, 0),
 
+          // Unison: detuned oscillator copies per voice, spread across the stereo field
+          std::make_unique<juce::AudioParameterInt>("unisonVoices", "Unison Voices", 1, 16, 1),
+          std::make_unique<juce::AudioParameterFloat>("unisonDetune", "Unison Detune", 0.0f, 100.0f, 20.0f),
+          std::make_unique<juce::AudioParameterFloat>("unisonSpread", "Unison Spread", 0.0f, 1.0f, 0.5f),
+
+          // Voice rendering across cores, once at least this many voices sound
+          std::make_unique<juce::AudioParameterBool>("multiCore", "Multi-Core Voices", false),
+          std::make_unique<juce::AudioParameterInt>("multiCoreVoices", "Multi-Core Voice Threshold", 2, 32, 6),
+
           // Octave control
           std::make_unique<juce::AudioParameterInt>("octave", "Octave", 2, 6, 4),
 
+          // Live MIDI stage
+          std::make_unique<juce::AudioParameterChoice>("arpMode", "Arp Mode",
+                                                      juce::StringArray{"Off", "Up", "Down", "Up/Down", "As Played", "Random", "Chord"}, 0),
+          std::make_unique<juce::AudioParameterChoice>("arpRate", "Arp Rate",
+                                                      juce::StringArray{"1/4", "1/8", "1/16", "1/32", "1/8T", "1/16T"}, 2),
+          std::make_unique<juce::AudioParameterInt>("arpOctaves", "Arp Octaves", 1, 4, 1),
+          std::make_unique<juce::AudioParameterFloat>("arpGate", "Arp Gate", 0.05f, 1.0f, 0.5f),
+          std::make_unique<juce::AudioParameterBool>("chordMemory", "Chord Memory", false),
+          std::make_unique<juce::AudioParameterBool>("scaleQuantise", "Scale Quantise", false),
+
+          // MPE controllers: 48 semitone per-note bend instead of a keyboard's 2
+          std::make_unique<juce::AudioParameterBool>("mpe", "MPE", false),
+
           // EQ parameters
           std::make_unique<juce::AudioParameterFloat>("lowShelfFreq", "Low Shelf Freq", minFrequency, 500.0f, 80.0f),
           std::make_unique<juce::AudioParameterFloat>("lowShelfGain", "Low Shelf Gain", -24.0f, 24.0f, 0.0f),
@@ -46,6 +94,11 @@ WorkstationProcessor::WorkstationProcessor()
           std::make_unique<juce::AudioParameterFloat>("reverbDamping", "Reverb Damping", 0.0f, 1.0f, 0.5f),
           std::make_unique<juce::AudioParameterFloat>("reverbWetLevel", "Reverb Wet Level", 0.0f, 1.0f, 0.2f),
           std::make_unique<juce::AudioParameterFloat>("reverbDryLevel", "Reverb Dry Level", 0.0f, 1.0f, 0.8f),
+          std::make_unique<juce::AudioParameterChoice>("reverbMode", "Reverb Mode",
+                                                      juce::StringArray{"Classic", "Fast", "Dense", "Convolution"}, 0),
+
+          // Snapshot morph macro
+          std::make_unique<juce::AudioParameterFloat>("morph", "Morph", 0.0f, 1.0f, 0.0f),
           
       })
       , forwardFFT(fftOrder)
@@ -53,7 +106,24 @@ WorkstationProcessor::WorkstationProcessor()
     // Setup synthesizer
     synth.addSound(new SineWaveSound());
     for (auto i = 0; i < 4; ++i)
-        synth.addVoice(new SineWaveVoice());
+        synth.addVoice(new WorkstationVoice());
+
+    // Under MPE, master-channel bends reach every voice in the zone
+    synth.setZoneBendHandler([] (juce::SynthesiserVoice& voice, int wheelValue)
+    {
+        if (auto* workstationVoice = dynamic_cast<WorkstationVoice*>(&voice))
+            workstationVoice->zonePitchWheelMoved(wheelValue);
+    });
+
+    // Sequencer lanes get voices of their own, driven only by the sequencer, so live
+    // playing and the lanes never steal from each other whatever channels come in
+    static const int laneVoices[] = { 2, 3, 2, 2 }; // Melody, chords, bass, percussion
+    laneSynth.addSound(new SineWaveSound());
+    for (int lane = 0; lane < StepSequencer::numLanes; ++lane)
+        laneSynth.addReservedVoices(StepSequencer::getLaneChannel(lane), laneVoices[lane], [] { return new WorkstationVoice(); });
+
+    synth.setParallelRenderer(&parallelRenderer);
+    laneSynth.setParallelRenderer(&parallelRenderer);
     
     // Initialise FFT data
     fftData.fill(0.0f);
@@ -62,20 +132,81 @@ WorkstationProcessor::WorkstationProcessor()
     
     // Initialize MIDI device list
     refreshMidiDevices();
+
+    // Presets cover every ranged parameter; buffers are sized here so a switch never allocates
+    for (auto* parameter : getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            presetParameters.push_back(ranged);
+            presetRawValues.push_back(valueTreeState.getRawParameterValue(ranged->paramID));
+            presetParameterIDs.add(ranged->paramID);
+        }
+    }
+
+    // Morph targets read straight from the parameters' atomics
+    static_assert((int) std::size(morphTargetIDs) == numMorphTargets, "One ID per morph target");
+    for (size_t i = 0; i < morphSources.size(); ++i)
+    {
+        morphSources[i] = valueTreeState.getRawParameterValue(morphTargetIDs[i]);
+        logarithmicMorphTargets[i] = isLogarithmicMorphTarget(morphTargetIDs[i]);
+    }
+
+    morphParameter = valueTreeState.getRawParameterValue("morph");
+
+    for (size_t i = 0; i < displayedMorphValues.size(); ++i)
+        displayedMorphValues[i].store(morphSources[i]->load());
+
+    arpModeParameter = valueTreeState.getRawParameterValue("arpMode");
+    arpRateParameter = valueTreeState.getRawParameterValue("arpRate");
+    arpOctavesParameter = valueTreeState.getRawParameterValue("arpOctaves");
+    arpGateParameter = valueTreeState.getRawParameterValue("arpGate");
+    chordMemoryParameter = valueTreeState.getRawParameterValue("chordMemory");
+    scaleQuantiseParameter = valueTreeState.getRawParameterValue("scaleQuantise");
+    multiCoreParameter = valueTreeState.getRawParameterValue("multiCore");
+    multiCoreVoicesParameter = valueTreeState.getRawParameterValue("multiCoreVoices");
+
+    pendingPreset.resize(presetParameters.size());
+    activePreset.resize(presetParameters.size());
+    presetScratch.resize(presetParameters.size());
+    publishedPreset.resize(presetParameters.size());
+    // A bank that won't open reads as empty, and the next save moves it aside instead of overwriting it
+    presetBank.open(PresetBank::getDefaultFile());
+
+    // User patterns, compiled here so the generator has a table before the first block
+    juce::String patternError;
+    patternLibrary.load(PatternLibrary::getDefaultFile(), patternError);
+    applyLaneDefinitions();
+
+    // The two parameters the reported latency depends on
+    valueTreeState.addParameterListener("oversampling", this);
+    valueTreeState.addParameterListener("renderHighQuality", this);
+}
+
+WorkstationProcessor::~WorkstationProcessor()
+{
+    valueTreeState.removeParameterListener("oversampling", this);
+    valueTreeState.removeParameterListener("renderHighQuality", this);
+    cancelPendingUpdate();
 }
 
 void WorkstationProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    analysisSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
     
-    // Prepare synthesizer
-    synth.setCurrentPlaybackSampleRate(sampleRate);
-    
-    for (auto i = 0; i < synth.getNumVoices(); ++i)
+    // Prepare synthesizers
+    for (auto* voiceSynth : { &synth, &laneSynth })
     {
-        if (auto voice = dynamic_cast<SineWaveVoice*>(synth.getVoice(i)))
+        voiceSynth->setCurrentPlaybackSampleRate(sampleRate);
+
+        for (auto i = 0; i < voiceSynth->getNumVoices(); ++i)
         {
-            voice->prepareFilter(sampleRate);
+            if (auto voice = dynamic_cast<WorkstationVoice*>(voiceSynth->getVoice(i)))
+            {
+                voice->prepare(sampleRate, samplesPerBlock);
+            }
         }
     }
     
@@ -86,12 +217,54 @@ void WorkstationProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     spec.numChannels = 2;
     
     eqChain.prepare(spec);
+
+    // Morph glide, and the values the first block's updates read
+    morphPosition.reset(sampleRate, 0.05);
+    presetGain.reset(sampleRate, presetFadeSeconds);
+    presetGain.setCurrentAndTargetValue(1.0f);
+    presetFadingOut = false;
+    glideProgress.reset(sampleRate, randomGlideSeconds);
+    glideActive = false;
+    morphPosition.setCurrentAndTargetValue(morphParameter->load());
+    updateMorphSnapshots();
+    updateMorphValues();
+
+    eqCache.fill(std::numeric_limits<float>::quiet_NaN()); // Rebuild every band for the new rate
     updateEQParameters();
+
+    scope.prepare(sampleRate);
+    meters.prepare(spec);
     
-    // Prepare reverb
-    reverb.prepare(spec);
+    // Prepare reverb (parameters first so the smoothers start at their targets)
     updateReverbParameters();
-    
+    reverb.prepare(spec);
+
+    // Prepare every oversampling factor up front so switching never allocates
+    for (size_t i = 1; i < oversamplers.size(); ++i)
+    {
+        oversamplers[i] = std::make_unique<juce::dsp::Oversampling<float>>(
+            2, i, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+        oversamplers[i]->initProcessing((size_t) samplesPerBlock);
+    }
+
+    oversampledMidi.ensureSize(4096);
+    oversampledLaneMidi.ensureSize(4096);
+    laneMidi.ensureSize(4096);
+
+    // Workers and their scratch buffers sized for the largest oversampled block
+    parallelRenderer.prepare(2, samplesPerBlock << maxOversamplingIndex, sampleRate, samplesPerBlock);
+    transposedMidi.ensureSize(4096);
+    liveMidi.prepare(sampleRate);
+
+    latencyCompensation.prepare(spec);
+    latencyCompensation.setMaximumDelayInSamples(
+        juce::jmax(1, (int) oversamplers[maxOversamplingIndex]->getLatencyInSamples()));
+
+    // Re-prepares the voices at the oversampled rate and reports latency before playback starts
+    activeOversamplingIndex = -1;
+    updateQualityProfile();
+    updateOversampling();
+    reportLatency();
 }
 
 void WorkstationProcessor::releaseResources()
@@ -101,77 +274,67 @@ void WorkstationProcessor::releaseResources()
 void WorkstationProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+
+    // Starts, or finishes, a preset switch at this block boundary
+    advancePresetSwitch();
     
-    // Generate built-in MIDI patterns if enabled
-    if (patternPlaying)
-    {
-        generateMIDIPattern(midiMessages, buffer.getNumSamples());
-    }
+    // Keyboard MIDI through the arpeggiator, chord memory and scale quantise
+    processLiveMidi(midiMessages, buffer.getNumSamples());
+
+    // Built-in sequencer, or the note-offs and rewind after it's been stopped. Its
+    // events stay in a buffer of their own for the lane voices, so incoming MIDI
+    // can use any channel (an MPE zone spans 2-16) without meeting a lane
+    laneMidi.clear();
+    if (patternPlaying.load())
+        sequencer.process(laneMidi, buffer.getNumSamples(), getPatternStepSamples(), rootKey);
+    else if (sequencer.isRunning())
+        sequencer.stop(laneMidi, 0);
 
-    // Apply octave transposition to all incoming MIDI
+    // Apply octave transposition to the incoming MIDI and the pitched lanes
     int octaveParam = valueTreeState.getRawParameterValue("octave")->load();
     int octaveShift = (octaveParam - 4) * 12; // Offset from default octave 4
 
     if (octaveShift != 0)
     {
-        juce::MidiBuffer transposedMidi;
-
-        for (const auto& message : midiMessages)
-        {
-            auto midiMessage = message.getMessage();
+        applyOctaveShift(midiMessages, octaveShift, 0);
 
-            if (midiMessage.isNoteOn() || midiMessage.isNoteOff())
-            {
-                int newNote = midiMessage.getNoteNumber() + octaveShift;
-                newNote = juce::jlimit(0, 127, newNote); // Keep in valid MIDI range
-
-                if (midiMessage.isNoteOn())
-                    midiMessage = juce::MidiMessage::noteOn(midiMessage.getChannel(), newNote, midiMessage.getVelocity());
-                else
-                    midiMessage = juce::MidiMessage::noteOff(midiMessage.getChannel(), newNote, midiMessage.getVelocity());
-            }
+        // Drum notes pick kit pieces rather than pitches, so the percussion lane stays put
+        applyOctaveShift(laneMidi, octaveShift, StepSequencer::getLaneChannel(StepSequencer::percussionLane));
+    }
 
-            transposedMidi.addEvent(midiMessage, message.samplePosition);
-        }
+    // Live or offline (bounce) quality profile for this block
+    updateQualityProfile();
 
-        midiMessages.swapWith(transposedMidi);
-    }
+    // Morph macro: pick up snapshot edits and glide towards the macro's value
+    updateMorphSnapshots();
+    morphPosition.setTargetValue(morphParameter->load());
+    updateMorphValues();
 
     // Update synth parameters if they've changed
     updateSynthParameters();
     
-    // Process synthesizer
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    // Process synthesizer and distortion (oversampled when enabled)
+    updateOversampling();
+    parallelRenderer.setEnabled(multiCoreParameter->load() >= 0.5f);
+    parallelRenderer.setVoiceThreshold((int) multiCoreVoicesParameter->load());
+    renderSynthSection(buffer, midiMessages, laneMidi);
     
-    // Apply distortion
-    float distortionAmount = valueTreeState.getRawParameterValue("distortion")->load();
-    if (distortionAmount > 1.0f)
-    {
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-        {
-            float* channelData = buffer.getWritePointer(channel);
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                // Soft clipping distortion
-                float input = channelData[sample] * distortionAmount;
-                channelData[sample] = std::tanh(input) / distortionAmount * 0.7f; // Compensate gain
-            }
-        }
-    }
     
+    // Process EQ (advances the morph glide through the block)
+    processEQ(buffer);
     
-    // Update parameters
-    updateEQParameters();
+    // Process Reverb (smooths its own parameters from the end-of-block values)
     updateReverbParameters();
-    
-    // Process EQ
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::ProcessContextReplacing<float> context(block);
-    eqChain.process(context);
-    
-    
-    // Process Reverb
     reverb.process(context);
+
+    // Preset switch fade, held at silence until the switch has been applied
+    if (presetGain.isSmoothing() || presetGain.getTargetValue() != 1.0f)
+        presetGain.applyGain(buffer, buffer.getNumSamples());
+
+    // Both output channels, after everything else in the chain
+    meters.process(buffer);
     
     // Capture audio data for visualization
     if (buffer.getNumSamples() > 0 && buffer.getNumChannels() > 0)
@@ -185,6 +348,10 @@ void WorkstationProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
             waveformIndex = (waveformIndex + 1) % waveformSize;
         }
         
+        // Scope sweeps from the mid signal, so the reverb's right channel is included
+        scope.pushSamples(channelData, buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr,
+                          buffer.getNumSamples());
+        
         // FFT data collection
         for (int i = 0; i < buffer.getNumSamples(); ++i)
         {
@@ -196,108 +363,378 @@ void WorkstationProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
                 // Process FFT with peak hold
                 processFFTWithPeakHold(fftData, magnitudes);
                 fftDataIndex = 0;
+                ++fftFrameCount;
             }
         }
     }
 }
 
+void WorkstationProcessor::applyOctaveShift(juce::MidiBuffer& midi, int octaveShift, int fixedChannel)
+{
+    transposedMidi.clear();
+
+    for (const auto& message : midi)
+    {
+        auto midiMessage = message.getMessage();
+
+        if ((midiMessage.isNoteOn() || midiMessage.isNoteOff()) && midiMessage.getChannel() != fixedChannel)
+        {
+            int newNote = midiMessage.getNoteNumber() + octaveShift;
+            newNote = juce::jlimit(0, 127, newNote); // Keep in valid MIDI range
+
+            if (midiMessage.isNoteOn())
+                midiMessage = juce::MidiMessage::noteOn(midiMessage.getChannel(), newNote, midiMessage.getVelocity());
+            else
+                midiMessage = juce::MidiMessage::noteOff(midiMessage.getChannel(), newNote, midiMessage.getVelocity());
+        }
+
+        transposedMidi.addEvent(midiMessage, message.samplePosition);
+    }
+
+    // Copied back rather than swapped so the preallocated scratch buffer is kept
+    midi.clear();
+    midi.addEvents(transposedMidi, 0, -1, 0);
+}
+
+void WorkstationProcessor::renderSynthSection(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
+                                              juce::MidiBuffer& laneMessages)
+{
+    auto* oversampler = oversamplers[(size_t) activeOversamplingIndex].get();
+
+    if (oversampler == nullptr)
+    {
+        synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+        laneSynth.renderNextBlock(buffer, laneMessages, 0, buffer.getNumSamples());
+        applyDistortion(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+    else
+    {
+        juce::dsp::AudioBlock<float> block(buffer);
+        auto channelBlock = block.getSubsetChannelBlock(0, juce::jmin((size_t) 2, block.getNumChannels()));
+        auto oversampledBlock = oversampler->processSamplesUp(channelBlock);
+
+        auto factor = (int) oversampler->getOversamplingFactor();
+        auto numChannels = (int) oversampledBlock.getNumChannels();
+        auto numSamples = (int) oversampledBlock.getNumSamples();
+
+        // MIDI timestamps move onto the oversampled timeline
+        auto oversampleTimestamps = [factor] (const juce::MidiBuffer& source, juce::MidiBuffer& destination)
+        {
+            destination.clear();
+            for (const auto metadata : source)
+                destination.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition * factor);
+        };
+
+        oversampleTimestamps(midiMessages, oversampledMidi);
+        oversampleTimestamps(laneMessages, oversampledLaneMidi);
+
+        // Wrap the oversampler's storage without copying or allocating
+        float* channels[2] = { oversampledBlock.getChannelPointer(0),
+                               oversampledBlock.getChannelPointer(numChannels > 1 ? 1 : 0) };
+        juce::AudioBuffer<float> oversampledBuffer(channels, numChannels, numSamples);
+
+        synth.renderNextBlock(oversampledBuffer, oversampledMidi, 0, numSamples);
+        laneSynth.renderNextBlock(oversampledBuffer, oversampledLaneMidi, 0, numSamples);
+        applyDistortion(channels, numChannels, numSamples);
+
+        oversampler->processSamplesDown(channelBlock);
+    }
+
+    // Pad lower-latency paths so the reported latency always holds
+    if (latencyCompensationSamples > 0)
+    {
+        juce::dsp::AudioBlock<float> block(buffer);
+        latencyCompensation.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+}
+
+void WorkstationProcessor::applyDistortion(float* const* channels, int numChannels, int numSamples)
+{
+    float distortionAmount = morphValues[morphDistortion];
+    if (distortionAmount <= 1.0f)
+        return;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* channelData = channels[channel];
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            // Soft clipping distortion
+            float input = channelData[sample] * distortionAmount;
+            channelData[sample] = std::tanh(input) / distortionAmount * 0.7f; // Compensate gain
+        }
+    }
+}
+
+int WorkstationProcessor::getOversamplingLatency(int index) const
+{
+    auto* oversampler = oversamplers[(size_t) index].get();
+    return oversampler != nullptr ? (int) oversampler->getLatencyInSamples() : 0;
+}
+
+void WorkstationProcessor::updateOversampling()
+{
+    if (oversamplers[maxOversamplingIndex] == nullptr)
+        return; // Not prepared yet
+
+    // With HQ Render on, the offline profile jumps straight to the highest factor
+    auto liveIndex = static_cast<int>(valueTreeState.getRawParameterValue("oversampling")->load());
+    bool renderHighQuality = valueTreeState.getRawParameterValue("renderHighQuality")->load() > 0.5f;
+    auto renderIndex = renderHighQuality ? maxOversamplingIndex : liveIndex;
+    auto index = offlineProfileActive ? renderIndex : liveIndex;
+
+    if (index != activeOversamplingIndex)
+    {
+        activeOversamplingIndex = index;
+        auto oversampledRate = currentSampleRate * (1 << index);
+
+        // Voices move to the oversampled rate in place, keeping held notes and
+        // filter states; nothing is allocated. The synth itself stays at the base
+        // rate, since its own rate change would stop every note.
+        for (auto* voiceSynth : { &synth, &laneSynth })
+        {
+            for (auto i = 0; i < voiceSynth->getNumVoices(); ++i)
+            {
+                if (auto voice = dynamic_cast<WorkstationVoice*>(voiceSynth->getVoice(i)))
+                    voice->setPlaybackRate(oversampledRate);
+            }
+        }
+
+        if (auto* oversampler = oversamplers[(size_t) index].get())
+            oversampler->reset();
+    }
+
+    // Delay the faster path up to the reported worst case, so switching between
+    // realtime and offline never shifts the output in time
+    auto compensation = getReportedLatency() - getOversamplingLatency(index);
+
+    if (compensation != latencyCompensationSamples)
+    {
+        latencyCompensationSamples = compensation;
+        latencyCompensation.reset();
+        latencyCompensation.setDelay((float) compensation);
+    }
+}
+
+int WorkstationProcessor::getReportedLatency() const
+{
+    if (oversamplers[maxOversamplingIndex] == nullptr)
+        return 0; // Not prepared yet
+
+    // The worst case of the live and render paths
+    auto liveIndex = static_cast<int>(valueTreeState.getRawParameterValue("oversampling")->load());
+    bool renderHighQuality = valueTreeState.getRawParameterValue("renderHighQuality")->load() > 0.5f;
+    auto renderIndex = renderHighQuality ? maxOversamplingIndex : liveIndex;
+    return juce::jmax(getOversamplingLatency(liveIndex), getOversamplingLatency(renderIndex));
+}
+
+void WorkstationProcessor::reportLatency()
+{
+    auto latency = getReportedLatency();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void WorkstationProcessor::parameterChanged(const juce::String&, float)
+{
+    // May be the audio thread (automation), so the report itself waits for the message thread
+    triggerAsyncUpdate();
+}
+
+void WorkstationProcessor::handleAsyncUpdate()
+{
+    reportLatency();
+}
+
+void WorkstationProcessor::updateQualityProfile()
+{
+    // Bounces get the expensive paths; monitoring keeps the lean live profile.
+    // The dense reverb and band-limited oscillators add no latency, so every
+    // bounce gets them; only 8x oversampling waits for the HQ Render switch, and
+    // updateOversampling pads the live path to its latency, so both profiles
+    // land on exactly the same samples.
+    offlineProfileActive = isNonRealtime();
+}
+
 void WorkstationProcessor::updateSynthParameters()
 {
-    auto currentAttack = valueTreeState.getRawParameterValue("attack")->load();
-    auto currentDecay = valueTreeState.getRawParameterValue("decay")->load();
-    auto currentSustain = valueTreeState.getRawParameterValue("sustain")->load();
-    auto currentRelease = valueTreeState.getRawParameterValue("release")->load();
-    auto currentFilterCutoff = valueTreeState.getRawParameterValue("filterCutoff")->load();
-    auto currentFilterResonance = valueTreeState.getRawParameterValue("filterResonance")->load();
+    auto currentAttack = morphValues[morphAttack];
+    auto currentDecay = morphValues[morphDecay];
+    auto currentSustain = morphValues[morphSustain];
+    auto currentRelease = morphValues[morphRelease];
+    auto currentFilterCutoff = morphValues[morphFilterCutoff];
+    auto currentFilterResonance = morphValues[morphFilterResonance];
 
     // New synthesis parameters
     auto currentWaveform = static_cast<int>(valueTreeState.getRawParameterValue("waveform")->load());
     auto currentFilterType = static_cast<int>(valueTreeState.getRawParameterValue("filterType")->load());
-    auto currentLfoRate = valueTreeState.getRawParameterValue("lfoRate")->load();
-    auto currentLfoDepth = valueTreeState.getRawParameterValue("lfoDepth")->load();
+    auto currentLfoRate = morphValues[morphLfoRate];
+    auto currentLfoDepth = morphValues[morphLfoDepth];
     auto currentLfoWaveform = static_cast<int>(valueTreeState.getRawParameterValue("lfoWaveform")->load());
+    auto currentMpe = static_cast<int>(valueTreeState.getRawParameterValue("mpe")->load());
+    auto currentUnisonVoices = static_cast<int>(valueTreeState.getRawParameterValue("unisonVoices")->load());
+    auto currentUnisonDetune = valueTreeState.getRawParameterValue("unisonDetune")->load();
+    auto currentUnisonSpread = valueTreeState.getRawParameterValue("unisonSpread")->load();
 
     bool parametersChanged = (currentAttack != lastAttack || currentDecay != lastDecay ||
                              currentSustain != lastSustain || currentRelease != lastRelease ||
                              currentFilterCutoff != lastFilterCutoff || currentFilterResonance != lastFilterResonance);
 
-    // Always update synthesis parameters (they're lightweight)
-    for (auto i = 0; i < synth.getNumVoices(); ++i)
+    bool synthesisChanged = (currentWaveform != lastWaveform || currentFilterType != lastFilterType ||
+                            currentLfoRate != lastLfoRate || currentLfoDepth != lastLfoDepth ||
+                            currentLfoWaveform != lastLfoWaveform || offlineProfileActive != lastOfflineProfile ||
+                            currentMpe != lastMpe || currentUnisonVoices != lastUnisonVoices ||
+                            currentUnisonDetune != lastUnisonDetune || currentUnisonSpread != lastUnisonSpread);
+
+    if (!parametersChanged && !synthesisChanged)
+        return;
+
+    for (auto* voiceSynth : { &synth, &laneSynth })
     {
-        if (auto voice = dynamic_cast<SineWaveVoice*>(synth.getVoice(i)))
+        for (auto i = 0; i < voiceSynth->getNumVoices(); ++i)
         {
-            if (parametersChanged)
+            if (auto voice = dynamic_cast<WorkstationVoice*>(voiceSynth->getVoice(i)))
             {
-                voice->setADSRParameters({currentAttack, currentDecay, currentSustain, currentRelease});
-                voice->setFilterParameters(currentFilterCutoff, currentFilterResonance);
-            }
+                if (parametersChanged)
+                {
+                    voice->setADSRParameters({currentAttack, currentDecay, currentSustain, currentRelease});
+                    voice->setFilterParameters(currentFilterCutoff, currentFilterResonance);
+                }
 
-            // Update new synthesis parameters
-            voice->setWaveformType(static_cast<WaveformType>(currentWaveform));
-            voice->setFilterType(static_cast<FilterType>(currentFilterType));
-                voice->setLFOParameters(currentLfoRate, currentLfoDepth, static_cast<WaveformType>(currentLfoWaveform));
+                if (synthesisChanged)
+                {
+                    voice->setWaveformType(static_cast<WaveformType>(currentWaveform));
+                    voice->setBandLimited(offlineProfileActive); // PolyBLEP oscillators for bounces
+                    voice->setFilterType(static_cast<FilterType>(currentFilterType));
+                    voice->setLFOParameters(currentLfoRate, currentLfoDepth, static_cast<WaveformType>(currentLfoWaveform));
+                    voice->setPitchBendRange(currentMpe != 0 ? 48.0f : 2.0f);
+                    voice->setUnison(currentUnisonVoices, currentUnisonDetune, currentUnisonSpread);
+                }
+            }
         }
     }
 
-    if (parametersChanged)
-    {
-        lastAttack = currentAttack;
-        lastDecay = currentDecay;
-        lastSustain = currentSustain;
-        lastRelease = currentRelease;
-        lastFilterCutoff = currentFilterCutoff;
-        lastFilterResonance = currentFilterResonance;
-    }
+    // MPE lower zone: channel 1 is the master, its bend moving every note by up to 2 semitones
+    synth.setZoneMasterChannel(currentMpe != 0 ? 1 : 0);
+
+    lastAttack = currentAttack;
+    lastDecay = currentDecay;
+    lastSustain = currentSustain;
+    lastRelease = currentRelease;
+    lastFilterCutoff = currentFilterCutoff;
+    lastFilterResonance = currentFilterResonance;
+    lastWaveform = currentWaveform;
+    lastFilterType = currentFilterType;
+    lastLfoRate = currentLfoRate;
+    lastLfoDepth = currentLfoDepth;
+    lastLfoWaveform = currentLfoWaveform;
+    lastMpe = currentMpe;
+    lastUnisonVoices = currentUnisonVoices;
+    lastUnisonDetune = currentUnisonDetune;
+    lastUnisonSpread = currentUnisonSpread;
+    lastOfflineProfile = offlineProfileActive;
 }
 
 void WorkstationProcessor::updateEQParameters()
 {
+    // Only bands whose values moved are rebuilt, and coefficients are written in
+    // place, so morph sweeps and automation never allocate on the audio thread
+    auto bandChanged = [this](std::initializer_list<int> targets)
+    {
+        bool changed = false;
+        for (auto target : targets)
+        {
+            changed = changed || morphValues[(size_t) target] != eqCache[(size_t) target];
+            eqCache[(size_t) target] = morphValues[(size_t) target];
+        }
+        return changed;
+    };
+
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+
     // Low shelf filter
-    auto& lowShelf = eqChain.get<0>();
-    *lowShelf.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        currentSampleRate, 
-        valueTreeState.getRawParameterValue("lowShelfFreq")->load(), 
-        0.7f, 
-        juce::Decibels::decibelsToGain(valueTreeState.getRawParameterValue("lowShelfGain")->load()));
+    if (bandChanged({ morphLowShelfFreq, morphLowShelfGain }))
+        *eqChain.get<0>().state = ArrayCoefficients::makeLowShelf(
+            currentSampleRate,
+            morphValues[morphLowShelfFreq],
+            0.7f,
+            juce::Decibels::decibelsToGain(morphValues[morphLowShelfGain]));
     
     // Peak filters
-    auto& peak1 = eqChain.get<1>();
-    *peak1.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        currentSampleRate,
-        valueTreeState.getRawParameterValue("peak1Freq")->load(),
-        valueTreeState.getRawParameterValue("peak1Q")->load(),
-        juce::Decibels::decibelsToGain(valueTreeState.getRawParameterValue("peak1Gain")->load()));
+    if (bandChanged({ morphPeak1Freq, morphPeak1Gain, morphPeak1Q }))
+        *eqChain.get<1>().state = ArrayCoefficients::makePeakFilter(
+            currentSampleRate,
+            morphValues[morphPeak1Freq],
+            morphValues[morphPeak1Q],
+            juce::Decibels::decibelsToGain(morphValues[morphPeak1Gain]));
         
-    auto& peak3 = eqChain.get<2>();
-    *peak3.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        currentSampleRate,
-        valueTreeState.getRawParameterValue("peak3Freq")->load(),
-        valueTreeState.getRawParameterValue("peak3Q")->load(),
-        juce::Decibels::decibelsToGain(valueTreeState.getRawParameterValue("peak3Gain")->load()));
+    if (bandChanged({ morphPeak3Freq, morphPeak3Gain, morphPeak3Q }))
+        *eqChain.get<2>().state = ArrayCoefficients::makePeakFilter(
+            currentSampleRate,
+            morphValues[morphPeak3Freq],
+            morphValues[morphPeak3Q],
+            juce::Decibels::decibelsToGain(morphValues[morphPeak3Gain]));
     
     // High shelf filter
-    auto& highShelf = eqChain.get<3>();
-    *highShelf.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        currentSampleRate,
-        valueTreeState.getRawParameterValue("highShelfFreq")->load(),
-        0.7f,
-        juce::Decibels::decibelsToGain(valueTreeState.getRawParameterValue("highShelfGain")->load()));
+    if (bandChanged({ morphHighShelfFreq, morphHighShelfGain }))
+        *eqChain.get<3>().state = ArrayCoefficients::makeHighShelf(
+            currentSampleRate,
+            morphValues[morphHighShelfFreq],
+            0.7f,
+            juce::Decibels::decibelsToGain(morphValues[morphHighShelfGain]));
+}
+
+void WorkstationProcessor::processEQ(juce::AudioBuffer<float>& buffer)
+{
+    juce::dsp::AudioBlock<float> block(buffer);
+    auto numSamples = buffer.getNumSamples();
+
+    // While the macro or a randomize glide moves, the EQ is stepped in short sub-blocks so sweeps don't zipper
+    auto gliding = (morphPosition.isSmoothing() && numMorphPoints >= 2) || glideActive;
+    auto step = gliding ? morphSubBlockSize : juce::jmax(1, numSamples);
+
+    for (int start = 0; start < numSamples; start += step)
+    {
+        auto length = juce::jmin(step, numSamples - start);
+        morphPosition.skip(length);
+        glideProgress.skip(length);
+        updateMorphValues();
+        updateEQParameters();
+
+        auto subBlock = block.getSubBlock((size_t) start, (size_t) length);
+        eqChain.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+    }
+
+    publishEQDisplayValues();
 }
 
 void WorkstationProcessor::updateReverbParameters()
 {
-    juce::dsp::Reverb::Parameters reverbParams;
-    reverbParams.roomSize = valueTreeState.getRawParameterValue("reverbRoomSize")->load();
-    reverbParams.damping = valueTreeState.getRawParameterValue("reverbDamping")->load();
-    reverbParams.wetLevel = valueTreeState.getRawParameterValue("reverbWetLevel")->load();
-    reverbParams.dryLevel = valueTreeState.getRawParameterValue("reverbDryLevel")->load();
-    reverbParams.width = 1.0f;      // Full stereo width
-    reverbParams.freezeMode = 0.0f; // No freeze mode
-    
+    // The engine ignores unchanged parameters and smooths the rest itself
+    ReverbEngine::Parameters reverbParams;
+    reverbParams.roomSize = morphValues[morphReverbRoomSize];
+    reverbParams.damping = morphValues[morphReverbDamping];
+    reverbParams.wetLevel = morphValues[morphReverbWetLevel];
+    reverbParams.dryLevel = morphValues[morphReverbDryLevel];
+    reverbParams.mode = static_cast<ReverbMode>(static_cast<int>(valueTreeState.getRawParameterValue("reverbMode")->load()));
+
+    // The fast FDN is for monitoring; bounces get the dense network with the same decay
+    if (offlineProfileActive && reverbParams.mode == ReverbMode::Fast)
+        reverbParams.mode = ReverbMode::Dense;
+
     reverb.setParameters(reverbParams);
 }
 
 
+void WorkstationProcessor::loadImpulseResponse(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return;
+
+    impulseResponseFile = file;
+    reverb.loadImpulseResponse(file);
+}
+
 void WorkstationProcessor::getFrequencyResponse(std::vector<float>& frequencies, std::vector<float>& magnitudes)
 {
     frequencies.clear();
@@ -307,17 +744,17 @@ void WorkstationProcessor::getFrequencyResponse(std::vector<float>& frequencies,
     const float minFreq = minFrequency;
     const float maxFreq = maxFrequency;
     
-    // Take snapshot of current parameter values
-    const float currentLowShelfFreq = valueTreeState.getRawParameterValue("lowShelfFreq")->load();
-    const float currentLowShelfGain = valueTreeState.getRawParameterValue("lowShelfGain")->load();
-    const float currentPeak1Freq = valueTreeState.getRawParameterValue("peak1Freq")->load();
-    const float currentPeak1Gain = valueTreeState.getRawParameterValue("peak1Gain")->load();
-    const float currentPeak1Q = valueTreeState.getRawParameterValue("peak1Q")->load();
-    const float currentPeak3Freq = valueTreeState.getRawParameterValue("peak3Freq")->load();
-    const float currentPeak3Gain = valueTreeState.getRawParameterValue("peak3Gain")->load();
-    const float currentPeak3Q = valueTreeState.getRawParameterValue("peak3Q")->load();
-    const float currentHighShelfFreq = valueTreeState.getRawParameterValue("highShelfFreq")->load();
-    const float currentHighShelfGain = valueTreeState.getRawParameterValue("highShelfGain")->load();
+    // The values the EQ is actually running on, morph and randomize glide included
+    const float currentLowShelfFreq = displayedMorphValues[morphLowShelfFreq].load();
+    const float currentLowShelfGain = displayedMorphValues[morphLowShelfGain].load();
+    const float currentPeak1Freq = displayedMorphValues[morphPeak1Freq].load();
+    const float currentPeak1Gain = displayedMorphValues[morphPeak1Gain].load();
+    const float currentPeak1Q = displayedMorphValues[morphPeak1Q].load();
+    const float currentPeak3Freq = displayedMorphValues[morphPeak3Freq].load();
+    const float currentPeak3Gain = displayedMorphValues[morphPeak3Gain].load();
+    const float currentPeak3Q = displayedMorphValues[morphPeak3Q].load();
+    const float currentHighShelfFreq = displayedMorphValues[morphHighShelfFreq].load();
+    const float currentHighShelfGain = displayedMorphValues[morphHighShelfGain].load();
     
     for (int i = 0; i < numPoints; ++i)
     {
@@ -363,17 +800,17 @@ void WorkstationProcessor::getIndividualBandResponses(std::vector<float>& freque
     const float minFreq = minFrequency;
     const float maxFreq = maxFrequency;
     
-    // Get current parameter values
-    const float currentLowShelfFreq = valueTreeState.getRawParameterValue("lowShelfFreq")->load();
-    const float currentLowShelfGain = valueTreeState.getRawParameterValue("lowShelfGain")->load();
-    const float currentPeak1Freq = valueTreeState.getRawParameterValue("peak1Freq")->load();
-    const float currentPeak1Gain = valueTreeState.getRawParameterValue("peak1Gain")->load();
-    const float currentPeak1Q = valueTreeState.getRawParameterValue("peak1Q")->load();
-    const float currentPeak3Freq = valueTreeState.getRawParameterValue("peak3Freq")->load();
-    const float currentPeak3Gain = valueTreeState.getRawParameterValue("peak3Gain")->load();
-    const float currentPeak3Q = valueTreeState.getRawParameterValue("peak3Q")->load();
-    const float currentHighShelfFreq = valueTreeState.getRawParameterValue("highShelfFreq")->load();
-    const float currentHighShelfGain = valueTreeState.getRawParameterValue("highShelfGain")->load();
+    // The values the EQ is actually running on, morph and randomize glide included
+    const float currentLowShelfFreq = displayedMorphValues[morphLowShelfFreq].load();
+    const float currentLowShelfGain = displayedMorphValues[morphLowShelfGain].load();
+    const float currentPeak1Freq = displayedMorphValues[morphPeak1Freq].load();
+    const float currentPeak1Gain = displayedMorphValues[morphPeak1Gain].load();
+    const float currentPeak1Q = displayedMorphValues[morphPeak1Q].load();
+    const float currentPeak3Freq = displayedMorphValues[morphPeak3Freq].load();
+    const float currentPeak3Gain = displayedMorphValues[morphPeak3Gain].load();
+    const float currentPeak3Q = displayedMorphValues[morphPeak3Q].load();
+    const float currentHighShelfFreq = displayedMorphValues[morphHighShelfFreq].load();
+    const float currentHighShelfGain = displayedMorphValues[morphHighShelfGain].load();
     
     for (int i = 0; i < numPoints; ++i)
     {
@@ -502,25 +939,18 @@ void WorkstationProcessor::processFFTWithPeakHold(std::array<float, fftSize * 2>
         else
         {
             fftPeakHold[j] *= 0.995f; // Very slow decay (hold peaks longer)
+
+            // Flushed once far below anything drawn, rather than crawling towards denormals
+            if (fftPeakHold[j] < 1.0e-7f)
+                fftPeakHold[j] = 0.0f;
         }
     }
 }
 
 void WorkstationProcessor::setPatternPlaying(bool shouldPlay)
 {
-    patternPlaying = shouldPlay;
-    
-    // If stopping, turn off all active notes immediately
-    if (!shouldPlay)
-    {
-        for (int i = 0; i < 128; ++i)
-        {
-            synth.noteOff(1, i, 0.0f, true); // All notes off
-        }
-        activeNotes.clear();
-        patternIndex = 0;
-        samplesUntilNextNote = 0;
-    }
+    // Stopping is done by the audio thread, which ends the sounding notes and rewinds
+    patternPlaying.store(shouldPlay);
 }
 
 juce::AudioProcessorEditor* WorkstationProcessor::createEditor()
@@ -528,113 +958,181 @@ juce::AudioProcessorEditor* WorkstationProcessor::createEditor()
     return new WorkstationEditor(*this);
 }
 
-void WorkstationProcessor::generateMIDIPattern(juce::MidiBuffer& midiBuffer, int numSamples)
+int WorkstationProcessor::getPatternStepSamples()
 {
-    // Define different musical modes (intervals from root)
-    static const int modes[][8] = {
-        {0, 2, 4, 5, 7, 9, 11, 12}, // Major (Ionian)
-        {0, 2, 3, 5, 7, 9, 10, 12}, // Minor (Natural Minor/Aeolian)
-        {0, 2, 3, 5, 7, 8, 10, 12}, // Dorian
-        {0, 1, 3, 5, 7, 8, 10, 12}, // Phrygian
-        {0, 2, 4, 6, 7, 9, 11, 12}, // Lydian
-        {0, 2, 4, 5, 7, 9, 10, 12}, // Mixolydian
-        {0, 1, 3, 5, 6, 8, 10, 12}, // Locrian
-    };
-    
-    // Define melody patterns
-    static const int melodyPatterns[][16] = {
-        {0, 1, 2, 3, 4, 5, 6, 7, 6, 5, 4, 3, 2, 1, 0, 0}, // Scale up/down
-        {0, 2, 4, 2, 0, 3, 5, 3, 0, 4, 6, 4, 0, 7, 0, 0}, // Arpeggios
-        {0, 4, 7, 4, 0, 3, 6, 3, 0, 5, 7, 5, 0, 2, 0, 0}, // Chord tones
-        {0, 2, 1, 3, 2, 4, 3, 5, 4, 6, 5, 7, 6, 7, 6, 5}, // Step pattern
-        {7, 5, 3, 1, 0, 2, 4, 6, 7, 6, 4, 2, 0, 1, 3, 5}, // Descending/ascending
-    };
-    
-    static const float velocities[] = {0.8f, 0.6f, 0.9f, 0.7f, 0.85f, 0.75f, 0.65f, 1.0f, 0.7f, 0.8f, 0.6f, 0.9f, 0.75f, 0.85f, 0.65f, 0.9f};
-    
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Sync to host tempo (Logic Pro, etc.) or use fixed tempo for standalone
+    if (auto* playHead = getPlayHead())
     {
-        if (samplesUntilNextNote <= 0)
+        auto positionInfo = playHead->getPosition();
+        if (positionInfo.hasValue() && positionInfo->getBpm().hasValue())
         {
-            // Stop any currently playing notes
-            for (int note : activeNotes)
-            {
-                midiBuffer.addEvent(juce::MidiMessage::noteOff(1, note), sample);
-            }
-            activeNotes.clear();
-            
-            // Get the current scale and pattern
-            const int* currentScale = modes[currentMode];
-            const int* currentPattern = melodyPatterns[melodyPattern];
-            
-            // Play new note(s)
-            int patternStep = patternIndex % 16;
-            int scaleStep = currentPattern[patternStep];
-            int note = rootKey + currentScale[scaleStep];
-            float velocity = velocities[patternIndex % 16];
-            
-            if (note >= 0 && note < 128)
-            {
-                midiBuffer.addEvent(juce::MidiMessage::noteOn(1, note, velocity), sample);
-                activeNotes.push_back(note);
-                
-                // Add harmony based on mode
-                if (patternIndex % 4 == 0)
-                {
-                    // Add third and fifth
-                    int thirdNote = rootKey + currentScale[(scaleStep + 2) % 7];
-                    int fifthNote = rootKey + currentScale[(scaleStep + 4) % 7];
-                    
-                    if (thirdNote < 128)
-                    {
-                        midiBuffer.addEvent(juce::MidiMessage::noteOn(1, thirdNote, velocity * 0.6f), sample);
-                        activeNotes.push_back(thirdNote);
-                    }
-                    if (fifthNote < 128)
-                    {
-                        midiBuffer.addEvent(juce::MidiMessage::noteOn(1, fifthNote, velocity * 0.5f), sample);
-                        activeNotes.push_back(fifthNote);
-                    }
-                }
-                
-                // Add bass root note an octave below with every melody note
-                int bassNote = rootKey - 12; // One octave down
-                if (bassNote >= 0)
-                {
-                    midiBuffer.addEvent(juce::MidiMessage::noteOn(1, bassNote, velocity * 0.6f), sample);
-                    activeNotes.push_back(bassNote);
-                }
-            }
-            
-            // Sync to host tempo (Logic Pro, etc.) or use fixed tempo for standalone
-            auto playHead = getPlayHead();
-            if (playHead != nullptr)
-            {
-                auto positionInfo = playHead->getPosition();
-                if (positionInfo.hasValue() && positionInfo->getBpm().hasValue())
-                {
-                    // Use host BPM for perfect sync with Logic Pro
-                    double hostBpm = *positionInfo->getBpm();
-                    double notesPerSecond = hostBpm / 60.0 * 2.0; // 2 notes per beat (eighth notes)
-                    int hostSyncedSamples = (int)(currentSampleRate / notesPerSecond);
-                    samplesUntilNextNote = hostSyncedSamples;
-                }
-                else
-                {
-                    // Fallback to fixed tempo if host info unavailable
-                    samplesUntilNextNote = samplesPerNote;
-                }
-            }
-            else
+            // Use host BPM for perfect sync with Logic Pro
+            double hostBpm = *positionInfo->getBpm();
+            double notesPerSecond = hostBpm / 60.0 * 2.0; // 2 notes per beat (eighth notes)
+            return (int)(currentSampleRate / notesPerSecond);
+        }
+    }
+
+    // Standalone mode, or no host tempo - use fixed tempo
+    return samplesPerNote;
+}
+
+void WorkstationProcessor::processLiveMidi(juce::MidiBuffer& midiMessages, int numSamples)
+{
+    // Arpeggiator step lengths in quarter notes, in the order of the "arpRate" choices
+    static const double arpRates[] = { 1.0, 0.5, 0.25, 0.125, 1.0 / 3.0, 1.0 / 6.0 };
+
+    LiveMidiStage::Settings settings;
+    settings.arpMode = (LiveMidiStage::ArpMode) juce::jlimit(0, (int) LiveMidiStage::ArpMode::chord, (int) arpModeParameter->load());
+    settings.arpRate = arpRates[juce::jlimit(0, (int) std::size(arpRates) - 1, (int) arpRateParameter->load())];
+    settings.arpOctaves = (int) arpOctavesParameter->load();
+    settings.arpGate = arpGateParameter->load();
+    settings.chordMemory = chordMemoryParameter->load() >= 0.5f;
+    settings.scaleQuantise = scaleQuantiseParameter->load() >= 0.5f;
+
+    // Steps follow the host's beat position while its transport runs, otherwise
+    // the stage's own clock at the host (or the generator's standalone) tempo
+    LiveMidiStage::Timing timing;
+    timing.bpm = 60.0 * currentSampleRate / (2.0 * samplesPerNote);
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            if (position->getBpm().hasValue())
+                timing.bpm = *position->getBpm();
+
+            if (position->getIsPlaying() && position->getPpqPosition().hasValue())
             {
-                // Standalone mode - use fixed tempo
-                samplesUntilNextNote = samplesPerNote;
+                timing.hostPlaying = true;
+                timing.ppq = *position->getPpqPosition();
             }
-            patternIndex++;
         }
-        
-        samplesUntilNextNote--;
     }
+
+    liveMidi.process(midiMessages, numSamples, settings, timing);
+}
+
+void WorkstationProcessor::updateLiveScale()
+{
+    liveMidi.setScale(rootKey % 12, patternLibrary.getScalePitchClasses(currentMode));
+}
+
+bool WorkstationProcessor::learnChordMemory()
+{
+    auto shape = liveMidi.getHeldShape();
+    if (juce::countNumberOfBits(shape) < 2)
+        return false;
+
+    liveMidi.setChordShape(shape);
+    return true;
+}
+
+void WorkstationProcessor::setMode(int newMode)
+{
+    currentMode = juce::jlimit(0, patternLibrary.getNumScales() - 1, newMode);
+    updateLiveScale();
+
+    for (int lane = 0; lane < StepSequencer::numLanes; ++lane)
+        postLane(lane);
+}
+
+void WorkstationProcessor::setLanePattern(int lane, int pattern)
+{
+    if (!juce::isPositiveAndBelow(lane, (int) StepSequencer::numLanes))
+        return;
+
+    lanePatterns[(size_t) lane] = juce::jlimit(0, patternLibrary.getNumPatterns() - 1, pattern);
+    postLane(lane);
+}
+
+void WorkstationProcessor::setLaneSettings(int lane, const StepSequencer::LaneSettings& settings)
+{
+    if (!juce::isPositiveAndBelow(lane, (int) StepSequencer::numLanes))
+        return;
+
+    auto& laneSetting = laneSettings[(size_t) lane];
+    laneSetting = settings;
+    laneSetting.length = juce::jlimit(0, PatternLibrary::maxSteps, settings.length);
+    laneSetting.swing = juce::jlimit(0.0f, 0.5f, settings.swing);
+    postLane(lane);
+}
+
+bool WorkstationProcessor::reloadPatternLibrary(juce::String& error)
+{
+    if (!patternLibrary.load(PatternLibrary::getDefaultFile(), error))
+        return false;
+
+    applyLaneDefinitions();
+    return true;
+}
+
+void WorkstationProcessor::applyLaneDefinitions()
+{
+    // Defaults: the selected melody over the triads, root pulse and (silent) beat,
+    // each overridden by whatever the pattern file says about its lane
+    static const char* const defaultPatterns[] = { nullptr, "Downbeat Triads", "Root Pulse", "Basic Beat" };
+
+    for (int lane = 0; lane < StepSequencer::numLanes; ++lane)
+    {
+        auto definition = patternLibrary.getLaneDefinition(StepSequencer::getLaneName(lane));
+        auto pattern = definition.pattern.isNotEmpty() ? patternLibrary.findPattern(definition.pattern)
+                     : defaultPatterns[lane] != nullptr ? patternLibrary.findPattern(defaultPatterns[lane])
+                     : lanePatterns[(size_t) lane];
+
+        StepSequencer::LaneSettings settings;
+        settings.enabled = definition.enabled >= 0 ? definition.enabled != 0 : lane != StepSequencer::percussionLane;
+        settings.length = juce::jmax(0, definition.length);
+        settings.swing = juce::jmax(0.0f, definition.swing);
+
+        lanePatterns[(size_t) lane] = juce::jlimit(0, patternLibrary.getNumPatterns() - 1, pattern);
+        laneSettings[(size_t) lane] = settings;
+    }
+
+    setMode(currentMode); // Clamps to the new scale list and posts every lane
+}
+
+void WorkstationProcessor::postLane(int lane)
+{
+    // Compiled (or fetched from the cache) before the sequencer's lock is taken,
+    // so the audio thread only ever waits on a copy
+    sequencer.postLane(lane, patternLibrary.getTable(lanePatterns[(size_t) lane], currentMode), laneSettings[(size_t) lane]);
+}
+
+bool WorkstationProcessor::exportPatternToMidiFile(const juce::File& file, int numSteps, double bpm, int midiFileType)
+{
+    constexpr int ticksPerQuarterNote = 960;
+    constexpr int ticksPerStep = ticksPerQuarterNote / 2; // Eighth notes, as in playback
+
+    if (numSteps <= 0)
+        return false;
+
+    // A sequencer of its own with one "sample" per tick, so event positions are
+    // tick times. A fixed seed makes probabilistic steps the same every export.
+    StepSequencer offline;
+    offline.setRandomSeed(1);
+    for (int lane = 0; lane < StepSequencer::numLanes; ++lane)
+        offline.setLane(lane, patternLibrary.getTable(lanePatterns[(size_t) lane], currentMode), laneSettings[(size_t) lane]);
+
+    juce::MidiBuffer rendered;
+    auto lengthInTicks = numSteps * ticksPerStep;
+    offline.process(rendered, lengthInTicks, ticksPerStep, rootKey);
+    offline.stop(rendered, lengthInTicks); // The last step's notes end with the pattern
+
+    // One track per lane (merged again for type 0), skipping lanes that didn't play
+    std::vector<std::pair<juce::String, juce::MidiMessageSequence>> tracks;
+    for (int lane = 0; lane < StepSequencer::numLanes; ++lane)
+    {
+        juce::MidiMessageSequence events;
+        for (const auto metadata : rendered)
+            if (metadata.getMessage().getChannel() == StepSequencer::getLaneChannel(lane))
+                events.addEvent(metadata.getMessage()); // Timestamped with its sample (tick) position
+
+        if (events.getNumEvents() > 0)
+            tracks.emplace_back("Konda " + StepSequencer::getLaneName(lane), std::move(events));
+    }
+
+    return MidiFileIO::write(file, tracks, bpm, ticksPerQuarterNote, midiFileType);
 }
 
 // MIDI device management functions
@@ -694,20 +1192,63 @@ void WorkstationProcessor::refreshMidiDevices()
 
 void WorkstationProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // Save both parameter state and MIDI device preference
-    auto state = valueTreeState.copyState();
-    
-    // Add MIDI device selection to the state
-    juce::ValueTree midiSettings("MidiSettings");
-    midiSettings.setProperty("selectedDevice", selectedMidiDevice, nullptr);
-    state.appendChild(midiSettings, nullptr);
-    
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Compact binary state: magic and version, then tagged sections with byte
+    // lengths so a build can skip sections it doesn't know about
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+
+    auto writeSection = [&stream](int tag, const juce::MemoryOutputStream& payload)
+    {
+        stream.writeInt(tag);
+        stream.writeInt((int) payload.getDataSize());
+        stream.write(payload.getData(), payload.getDataSize());
+    };
+
+    // Parameters as (ID, plain value) pairs, read straight from the parameters
+    // rather than copying the whole value tree
+    juce::MemoryOutputStream parameters;
+    for (auto* parameter : getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            parameters.writeString(ranged->paramID);
+            parameters.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+        }
+    }
+    writeSection(parameterSection, parameters);
+
+    // MIDI device preference
+    juce::MemoryOutputStream midiSettings;
+    midiSettings.writeString(selectedMidiDevice);
+    writeSection(midiSection, midiSettings);
+
+    // Convolution reverb impulse response (path only - the file stays on disk)
+    juce::MemoryOutputStream reverbSettings;
+    reverbSettings.writeString(impulseResponseFile.getFullPathName());
+    writeSection(reverbSection, reverbSettings);
+
+    juce::MemoryOutputStream morphSettings;
+    writeMorphSnapshots(morphSettings);
+    writeSection(morphSection, morphSettings);
+
+    // Learned chord memory shape
+    juce::MemoryOutputStream liveSettings;
+    liveSettings.writeInt((int) liveMidi.getChordShape());
+    writeSection(liveSection, liveSettings);
 }
 
 void WorkstationProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    juce::MemoryInputStream stream(data, (size_t) juce::jmax(0, sizeInBytes), false);
+
+    if (sizeInBytes >= 8 && stream.readInt() == stateMagic)
+    {
+        readBinaryState(stream);
+        return;
+    }
+
+    // Legacy XML state from builds before the binary format (version 0)
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     
     if (xmlState.get() != nullptr)
@@ -722,12 +1263,480 @@ void WorkstationProcessor::setStateInformation(const void* data, int sizeInBytes
             {
                 selectedMidiDevice = midiSettings.getProperty("selectedDevice", "");
             }
-            
-            valueTreeState.replaceState(newState);
+
+            // Reload the convolution impulse response in the background
+            auto reverbSettings = newState.getChildWithName("ReverbSettings");
+            if (reverbSettings.isValid())
+                restoreImpulseResponse(reverbSettings.getProperty("impulseResponse", ""));
+
+            // APVTS writes one PARAM child per parameter with its plain value
+            juce::NamedValueSet values;
+            for (const auto& child : newState)
+                if (child.hasType("PARAM"))
+                    values.set(juce::Identifier(child.getProperty("id").toString()), child.getProperty("value"));
+
+            applyParameterState(values, 0);
         }
     }
 }
 
+void WorkstationProcessor::readBinaryState(juce::MemoryInputStream& stream)
+{
+    auto version = stream.readInt();
+
+    // Sections from newer versions that this build doesn't know are skipped by length
+    while (stream.getNumBytesRemaining() >= 8)
+    {
+        auto tag = stream.readInt();
+        auto size = stream.readInt();
+
+        if (size < 0 || size > stream.getNumBytesRemaining())
+            break; // Truncated or corrupt - keep whatever was restored so far
+
+        juce::MemoryBlock payloadData;
+        stream.readIntoMemoryBlock(payloadData, size);
+        juce::MemoryInputStream payload(payloadData, false);
+
+        if (tag == parameterSection)
+        {
+            juce::NamedValueSet values;
+            while (! payload.isExhausted())
+            {
+                auto id = payload.readString();
+                auto value = payload.readFloat();
+
+                if (id.isNotEmpty())
+                    values.set(juce::Identifier(id), value);
+            }
+
+            applyParameterState(values, version);
+        }
+        else if (tag == midiSection)
+        {
+            selectedMidiDevice = payload.readString();
+        }
+        else if (tag == reverbSection)
+        {
+            restoreImpulseResponse(payload.readString());
+        }
+        else if (tag == morphSection)
+        {
+            readMorphSnapshots(payload);
+        }
+        else if (tag == liveSection)
+        {
+            liveMidi.setChordShape((juce::uint32) payload.readInt());
+        }
+    }
+}
+
+void WorkstationProcessor::applyParameterState(const juce::NamedValueSet& values, int version)
+{
+    // Every version so far shares the same parameter IDs and plain-value ranges,
+    // so nothing needs converting yet. A future rename or range change becomes
+    // a step here keyed on version, before values are applied.
+    juce::ignoreUnused(version);
+
+    for (auto* parameter : getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        if (ranged == nullptr)
+            continue;
+
+        // Anything the state doesn't mention (saved before it existed) goes back to its default
+        auto target = ranged->getDefaultValue();
+        if (auto* value = values.getVarPointer(juce::Identifier(ranged->paramID)))
+            target = ranged->convertTo0to1((float) *value);
+
+        // Only parameters that actually move notify the host and listeners
+        if (std::abs(ranged->getValue() - target) > 1.0e-6f)
+            ranged->setValueNotifyingHost(target);
+    }
+}
+
+void WorkstationProcessor::restoreImpulseResponse(const juce::String& path)
+{
+    if (path.isNotEmpty() && juce::File::isAbsolutePath(path) && juce::File(path) != impulseResponseFile)
+        loadImpulseResponse(juce::File(path));
+}
+
+void WorkstationProcessor::setCurrentProgram(int index)
+{
+    if (! juce::isPositiveAndBelow(index, presetBank.getNumPresets()))
+        return;
+
+    // Parameters the preset predates fall back to their defaults
+    for (size_t i = 0; i < presetParameters.size(); ++i)
+        presetScratch[i] = presetParameters[i]->convertFrom0to1(presetParameters[i]->getDefaultValue());
+
+    if (! presetBank.readPreset(index, presetParameterIDs, presetScratch.data()))
+        return;
+
+    for (size_t i = 0; i < presetParameters.size(); ++i)
+        presetScratch[i] = presetParameters[i]->convertTo0to1(presetScratch[i]);
+
+    std::copy(presetScratch.begin(), presetScratch.end(), publishedPreset.begin());
+    ++presetRequest;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(presetLock);
+        std::copy(presetScratch.begin(), presetScratch.end(), pendingPreset.begin());
+        pendingPresetRequest = presetRequest;
+        presetPending = true;
+    }
+
+    currentProgram = index;
+
+    // Polls for the audio thread having switched, then updates the parameters themselves
+    startTimer(presetPollIntervalMs);
+}
+
+void WorkstationProcessor::timerCallback()
+{
+    // An older switch landing first leaves its successor still to come
+    if (publishedPresetRequest != presetRequest && appliedPresetRequest.load() == presetRequest)
+    {
+        publishedPresetRequest = presetRequest;
+
+        // The DSP already runs on these values, so this only informs the host and listeners
+        for (size_t i = 0; i < presetParameters.size(); ++i)
+            if (std::abs(presetParameters[i]->getValue() - publishedPreset[i]) > 1.0e-6f)
+                presetParameters[i]->setValueNotifyingHost(publishedPreset[i]);
+    }
+
+    commitGlideParameters();
+
+    if (publishedPresetRequest == presetRequest && committedGlideRequest.load() == glideRequest)
+        stopTimer();
+}
+
+const juce::String WorkstationProcessor::getProgramName(int index)
+{
+    return presetBank.getNumPresets() > 0 ? presetBank.getName(index) : juce::String("Default");
+}
+
+void WorkstationProcessor::changeProgramName(int index, const juce::String& newName)
+{
+    if (presetBank.renamePreset(index, newName))
+        updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+}
+
+int WorkstationProcessor::savePreset(const juce::String& name)
+{
+    std::vector<float> values, defaults;
+    for (auto* parameter : presetParameters)
+    {
+        values.push_back(parameter->convertFrom0to1(parameter->getValue()));
+        defaults.push_back(parameter->convertFrom0to1(parameter->getDefaultValue()));
+    }
+
+    auto index = presetBank.storePreset(name, presetParameterIDs, values.data(), defaults.data());
+
+    if (index >= 0)
+    {
+        currentProgram = index;
+        updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    }
+
+    return index;
+}
+
+void WorkstationProcessor::advancePresetSwitch()
+{
+    // Once the fade-out has reached silence, the new values, a hard voice stop
+    // and cleared filter/reverb tails are all inaudible; then it fades back in
+    if (presetFadingOut)
+    {
+        if (presetGain.isSmoothing())
+            return;
+
+        presetFadingOut = false;
+        synth.allNotesOff(0, false);
+        laneSynth.allNotesOff(0, false);
+        applyActivePreset();
+        eqChain.reset();
+        reverb.reset();
+        presetGain.setTargetValue(1.0f);
+        return;
+    }
+
+    // Never wait on the message thread; a busy lock just picks the switch up next block
+    const juce::SpinLock::ScopedTryLockType lock(presetLock);
+
+    if (! lock.isLocked() || ! presetPending)
+        return;
+
+    std::copy(pendingPreset.begin(), pendingPreset.end(), activePreset.begin());
+    activePresetRequest = pendingPresetRequest;
+    presetPending = false;
+    presetFadingOut = true;
+
+    // Release held notes while the output fades out (from wherever a fade-in had got to)
+    synth.allNotesOff(0, true);
+    laneSynth.allNotesOff(0, true);
+    presetGain.setTargetValue(0.0f);
+}
+
+void WorkstationProcessor::storeMorphSnapshot(int slot)
+{
+    if (! juce::isPositiveAndBelow(slot, numMorphSnapshots))
+        return;
+
+    MorphSnapshot snapshot;
+    for (size_t i = 0; i < snapshot.size(); ++i)
+        snapshot[i] = morphSources[i]->load();
+
+    const juce::SpinLock::ScopedLockType lock(morphLock);
+    pendingSnapshots[(size_t) slot] = snapshot;
+    pendingStored[(size_t) slot] = true;
+    snapshotsChanged = true;
+}
+
+void WorkstationProcessor::clearMorphSnapshot(int slot)
+{
+    if (! juce::isPositiveAndBelow(slot, numMorphSnapshots))
+        return;
+
+    const juce::SpinLock::ScopedLockType lock(morphLock);
+    pendingStored[(size_t) slot] = false;
+    snapshotsChanged = true;
+}
+
+void WorkstationProcessor::writeMorphSnapshots(juce::MemoryOutputStream& stream)
+{
+    // Each stored slot: index, value count, then (ID, plain value) pairs
+    const juce::SpinLock::ScopedLockType lock(morphLock);
+
+    for (int slot = 0; slot < numMorphSnapshots; ++slot)
+    {
+        if (! pendingStored[(size_t) slot])
+            continue;
+
+        stream.writeInt(slot);
+        stream.writeInt(numMorphTargets);
+
+        for (size_t i = 0; i < (size_t) numMorphTargets; ++i)
+        {
+            stream.writeString(morphTargetIDs[i]);
+            stream.writeFloat(pendingSnapshots[(size_t) slot][i]);
+        }
+    }
+}
+
+void WorkstationProcessor::readMorphSnapshots(juce::MemoryInputStream& stream)
+{
+    std::array<MorphSnapshot, numMorphSnapshots> snapshots {};
+    std::array<bool, numMorphSnapshots> stored {};
+
+    while (stream.getNumBytesRemaining() >= 8)
+    {
+        auto slot = stream.readInt();
+        auto count = stream.readInt();
+        MorphSnapshot snapshot;
+
+        // Targets the state predates take their current control values
+        for (size_t i = 0; i < snapshot.size(); ++i)
+            snapshot[i] = morphSources[i]->load();
+
+        for (int i = 0; i < count && ! stream.isExhausted(); ++i)
+        {
+            auto id = stream.readString();
+            auto value = stream.readFloat();
+
+            for (size_t target = 0; target < snapshot.size(); ++target)
+                if (id == morphTargetIDs[target])
+                    snapshot[target] = value;
+        }
+
+        if (juce::isPositiveAndBelow(slot, numMorphSnapshots))
+        {
+            snapshots[(size_t) slot] = snapshot;
+            stored[(size_t) slot] = true;
+        }
+    }
+
+    const juce::SpinLock::ScopedLockType lock(morphLock);
+    pendingSnapshots = snapshots;
+    pendingStored = stored;
+    snapshotsChanged = true;
+}
+
+void WorkstationProcessor::updateMorphSnapshots()
+{
+    // Never wait on the message thread; a busy lock just picks the edit up next block
+    const juce::SpinLock::ScopedTryLockType lock(morphLock);
+
+    if (! lock.isLocked())
+        return;
+
+    if (glideRequested)
+    {
+        glideRequested = false;
+        startGlide(pendingGlideRequest);
+    }
+
+    if (! snapshotsChanged)
+        return;
+
+    snapshotsChanged = false;
+    numMorphPoints = 0;
+
+    for (int slot = 0; slot < numMorphSnapshots; ++slot)
+    {
+        activeStored[(size_t) slot] = pendingStored[(size_t) slot];
+        if (! activeStored[(size_t) slot])
+            continue;
+
+        // Logarithmic targets are interpolated in the log domain
+        auto& snapshot = activeSnapshots[(size_t) slot];
+        snapshot = pendingSnapshots[(size_t) slot];
+        for (size_t i = 0; i < snapshot.size(); ++i)
+            if (logarithmicMorphTargets[i])
+                snapshot[i] = std::log(juce::jmax(1.0e-3f, snapshot[i]));
+
+        morphPoints[(size_t) numMorphPoints++] = slot;
+    }
+}
+
+void WorkstationProcessor::updateMorphValues()
+{
+    // Without two snapshots to morph between, the controls apply directly
+    if (numMorphPoints < 2)
+    {
+        for (size_t i = 0; i < morphValues.size(); ++i)
+            morphValues[i] = morphSources[i]->load();
+    }
+    else
+    {
+        // The macro's range is split evenly between the stored snapshots
+        auto position = juce::jlimit(0.0f, 1.0f, morphPosition.getCurrentValue()) * (float) (numMorphPoints - 1);
+        auto segment = juce::jmin((int) position, numMorphPoints - 2);
+        auto fraction = position - (float) segment;
+        const auto& from = activeSnapshots[(size_t) morphPoints[(size_t) segment]];
+        const auto& to = activeSnapshots[(size_t) morphPoints[(size_t) segment + 1]];
+
+        for (size_t i = 0; i < morphValues.size(); ++i)
+        {
+            auto value = from[i] + fraction * (to[i] - from[i]);
+            morphValues[i] = logarithmicMorphTargets[i] ? std::exp(value) : value;
+        }
+    }
+
+    if (glideActive)
+        applyGlide();
+}
+
+void WorkstationProcessor::startGlide(int request)
+{
+    // The sound as it is now, held until the new parameter values are in place
+    for (size_t i = 0; i < morphValues.size(); ++i)
+        glideFrom[i] = logarithmicMorphTargets[i] ? std::log(juce::jmax(1.0e-3f, morphValues[i])) : morphValues[i];
+
+    activeGlideRequest = request;
+    glideActive = true;
+    glideProgress.setCurrentAndTargetValue(0.0f);
+    armedGlideRequest.store(request);
+}
+
+void WorkstationProcessor::applyGlide()
+{
+    // Released once the message thread has set the parameters this glide was armed for
+    if (glideProgress.getTargetValue() == 0.0f && committedGlideRequest.load() == activeGlideRequest)
+        glideProgress.setTargetValue(1.0f);
+
+    auto progress = glideProgress.getCurrentValue();
+    if (progress >= 1.0f)
+    {
+        glideActive = false;
+        return;
+    }
+
+    // From the held sound towards whatever the controls (or the morph) now give, in the same domains
+    for (size_t i = 0; i < morphValues.size(); ++i)
+    {
+        auto to = logarithmicMorphTargets[i] ? std::log(juce::jmax(1.0e-3f, morphValues[i])) : morphValues[i];
+        auto value = glideFrom[i] + progress * (to - glideFrom[i]);
+        morphValues[i] = logarithmicMorphTargets[i] ? std::exp(value) : value;
+    }
+}
+
+void WorkstationProcessor::glideToParameters(const juce::NamedValueSet& plainValues)
+{
+    // Merged into a set that hasn't been committed yet, so several randomizers land together
+    if (committedGlideRequest.load() == glideRequest)
+        glideParameters.clear();
+
+    for (auto& value : plainValues)
+    {
+        auto* parameter = valueTreeState.getParameter(value.name.toString());
+        if (parameter == nullptr)
+            continue;
+
+        auto normalised = parameter->convertTo0to1((float) value.value);
+        auto existing = std::find_if(glideParameters.begin(), glideParameters.end(),
+                                     [parameter](const auto& entry) { return entry.first == parameter; });
+
+        if (existing != glideParameters.end())
+            existing->second = normalised;
+        else
+            glideParameters.emplace_back(parameter, normalised);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(morphLock);
+        pendingGlideRequest = ++glideRequest;
+        glideRequested = true;
+    }
+
+    glideWaitTicks = 0;
+    startTimer(presetPollIntervalMs);
+}
+
+void WorkstationProcessor::commitGlideParameters()
+{
+    if (committedGlideRequest.load() == glideRequest)
+        return;
+
+    // Wait for the audio thread to hold the current sound, unless it isn't running at all
+    static constexpr int maxWaitTicks = 10;
+    if (armedGlideRequest.load() != glideRequest && ++glideWaitTicks < maxWaitTicks)
+        return;
+
+    for (auto& [parameter, value] : glideParameters)
+        if (std::abs(parameter->getValue() - value) > 1.0e-6f)
+            parameter->setValueNotifyingHost(value);
+
+    glideParameters.clear();
+    committedGlideRequest.store(glideRequest);
+}
+
+void WorkstationProcessor::publishEQDisplayValues()
+{
+    bool changed = false;
+
+    for (size_t i = morphLowShelfFreq; i <= morphHighShelfGain; ++i)
+    {
+        if (displayedMorphValues[i].load(std::memory_order_relaxed) != morphValues[i])
+        {
+            displayedMorphValues[i].store(morphValues[i], std::memory_order_relaxed);
+            changed = true;
+        }
+    }
+
+    if (changed)
+        eqDisplayVersion.fetch_add(1, std::memory_order_release);
+}
+
+void WorkstationProcessor::applyActivePreset()
+{
+    // Audio thread: only the raw values the DSP reads change here. Notifying the
+    // host and listeners is left to timerCallback on the message thread.
+    for (size_t i = 0; i < presetParameters.size(); ++i)
+        presetRawValues[i]->store(presetParameters[i]->convertFrom0to1(activePreset[i]));
+
+    appliedPresetRequest.store(activePresetRequest);
+}
+
 // Required for standalone builds
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
@@ -3,12 +3,23 @@
 #include <juce_dsp/juce_dsp.h>
 #include "SineWaveVoice.h"
 #include "SineWaveSound.h"
+#include "ReverbEngine.h"
+#include "ScopeCapture.h"
+#include "MeteringEngine.h"
+#include "PresetBank.h"
+#include "PatternLibrary.h"
+#include "StepSequencer.h"
+#include "VoiceGroupSynthesiser.h"
+#include "LiveMidiStage.h"
 
-class WorkstationProcessor : public juce::AudioProcessor
+class WorkstationProcessor : public juce::AudioProcessor,
+                             private juce::Timer,
+                             private juce::AsyncUpdater,
+                             private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     WorkstationProcessor();
-    ~WorkstationProcessor() override = default;
+    ~WorkstationProcessor() override;
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -23,11 +34,34 @@ public:
     bool isMidiEffect() const override { return false; }
     double getTailLengthSeconds() const override { return 0.0; }
 
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
-    void setCurrentProgram(int) override {}
-    const juce::String getProgramName(int) override { return "Default"; }
-    void changeProgramName(int, const juce::String&) override {}
+    // Programs come from the preset bank; an empty bank still reports one program
+    int getNumPrograms() override { return juce::jmax(1, presetBank.getNumPresets()); }
+    int getCurrentProgram() override { return currentProgram; }
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    // Preset library. Switches are applied by the audio thread at the next block boundary.
+    juce::StringArray getPresetNames() const { return presetBank.getNames(); }
+    int savePreset(const juce::String& name); // Returns the preset index, or -1 on failure
+
+    // Snapshot morph: the "morph" macro sweeps through the stored slots in order.
+    // Snapshots hold the continuous synth, EQ and reverb values; with fewer than
+    // two stored the macro does nothing and the controls apply as usual.
+    static constexpr int numMorphSnapshots = 4;
+    void storeMorphSnapshot(int slot);
+    void clearMorphSnapshot(int slot);
+    bool hasMorphSnapshot(int slot) const { return juce::isPositiveAndBelow(slot, numMorphSnapshots) && pendingStored[(size_t) slot]; }
+
+    // Randomize: sets these parameters (ID -> plain value), with the sound gliding
+    // from where it is to the new values over randomGlideSeconds on the morph path
+    // instead of jumping. Calls before the previous set lands are merged into it.
+    void glideToParameters(const juce::NamedValueSet& plainValues);
+    static constexpr double randomGlideSeconds = 0.3;
+
+    // EQ as the audio thread last applied it (morph and glide included), for drawing.
+    // The version changes whenever one of the values does.
+    int getEQDisplayVersion() const { return eqDisplayVersion.load(); }
 
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
@@ -42,20 +76,61 @@ public:
                                    std::vector<float>& peak3Response,
                                    std::vector<float>& highShelfResponse);
     
+    // Convolution reverb impulse response (loaded and resampled on a background thread)
+    void loadImpulseResponse(const juce::File& file);
+    juce::File getImpulseResponseFile() const { return impulseResponseFile; }
+
     // Live audio waveform data
     void getAudioWaveform(std::vector<float>& waveformData);
     
+    // Triggered oscilloscope sweeps (see ScopeCapture.h)
+    bool getScopeFrame(ScopeCapture::Frame& frame) { return scope.readFrame(frame); }
+    void setScopeTriggerMode(ScopeCapture::TriggerMode mode) { scope.setTriggerMode(mode); }
+
+    // Output metering: peak/RMS/true-peak, mid/side correlation and EBU R128 loudness
+    MeteringEngine::Readings getMeterReadings() const { return meters.getReadings(); }
+    void resetIntegratedLoudness() { meters.requestIntegratedReset(); }
+
     // FFT spectrum data
     void getFFTData(std::vector<float>& fftData);
     void getFFTPeakHold(std::vector<float>& peakHoldData);
+    int getFFTFrameCount() const { return fftFrameCount.load(); } // Bumped once per analysis frame
+
+    // Bins are getAnalysisSampleRate() / getFFTSize() Hz apart
+    double getAnalysisSampleRate() const { return analysisSampleRate.load(); }
+    static constexpr int getFFTSize() { return fftSize; }
     
     // Built-in MIDI pattern generator
     void setPatternPlaying(bool shouldPlay);
-    bool isPatternPlaying() const { return patternPlaying; }
-    void setKey(int newKey) { rootKey = newKey; }
-    void setMode(int newMode) { currentMode = newMode; }
-    void setMelodyPattern(int pattern) { melodyPattern = pattern; }
-    void setOctave(int octave) { rootKey = (octave * 12); } // Set root to C of specified octave
+    bool isPatternPlaying() const { return patternPlaying.load(); }
+    void setKey(int newKey) { rootKey = newKey; updateLiveScale(); }
+    void setOctave(int octave) { rootKey = (octave * 12); updateLiveScale(); } // Set root to C of specified octave
+
+    // Modes and patterns come from the pattern library (built-ins plus the user
+    // file). Changes are compiled here and picked up at the next bar boundary.
+    void setMode(int newMode);
+    void setMelodyPattern(int pattern) { setLanePattern(StepSequencer::melodyLane, pattern); }
+    int getMode() const { return currentMode; }
+    int getMelodyPattern() const { return lanePatterns[StepSequencer::melodyLane]; }
+
+    // Sequencer lanes (StepSequencer::Lane), each playing a library pattern on
+    // its own MIDI channel and reserved voices
+    void setLanePattern(int lane, int pattern);
+    int getLanePattern(int lane) const { return lanePatterns[(size_t) lane]; }
+    void setLaneSettings(int lane, const StepSequencer::LaneSettings& settings);
+    StepSequencer::LaneSettings getLaneSettings(int lane) const { return laneSettings[(size_t) lane]; }
+    juce::StringArray getModeNames() const { return patternLibrary.getScaleNames(); }
+    juce::StringArray getMelodyPatternNames() const { return patternLibrary.getPatternNames(); }
+    juce::File getPatternLibraryFile() const { return PatternLibrary::getDefaultFile(); }
+    bool reloadPatternLibrary(juce::String& error); // On error the current library stays in use
+
+    // Renders the sequencer's current key, mode and lanes offline as eighth
+    // notes at 960 PPQ, into a type 0 file or a type 1 file with a track per lane
+    bool exportPatternToMidiFile(const juce::File& file, int numSteps, double bpm, int midiFileType = 1);
+
+    // Live MIDI stage (arpeggiator, chord memory, scale quantise; see LiveMidiStage.h).
+    // Learning takes the shape of the keys held right now; it needs at least two.
+    bool learnChordMemory();
     
     // MIDI device management
     juce::StringArray getAvailableMidiDevices();
@@ -65,7 +140,16 @@ public:
 
 private:
     // Synthesizer
-    juce::Synthesiser synth;
+    // Worker pool for rendering voices on several cores (outlives the synth that uses it)
+    ParallelVoiceRenderer parallelRenderer;
+    std::atomic<float>* multiCoreParameter = nullptr;
+    std::atomic<float>* multiCoreVoicesParameter = nullptr;
+
+    // Shared voices for live and host MIDI, and a reserved group per sequencer lane
+    // in a synth of its own that only the sequencer's events reach
+    VoiceGroupSynthesiser synth;
+    VoiceGroupSynthesiser laneSynth;
+    juce::MidiBuffer laneMidi; // Preallocated; the sequencer's events for this block
     
     // EQ Chain (4 bands)
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> lowShelfFilter;
@@ -80,13 +164,23 @@ private:
         decltype(highShelfFilter)
     > eqChain;
     
-    // Reverb
-    juce::dsp::Reverb reverb;
+    // Reverb (Classic/Fast/Dense, bypassed when wet is zero)
+    ReverbEngine reverb;
+    juce::File impulseResponseFile;
     
 
     juce::AudioProcessorValueTreeState valueTreeState;
     double currentSampleRate = 44100.0;
     
+    // Oversampling for the synth + distortion section (index is log2 of the factor)
+    static constexpr int maxOversamplingIndex = 3; // 8x
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, maxOversamplingIndex + 1> oversamplers;
+    juce::MidiBuffer oversampledMidi, oversampledLaneMidi;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> latencyCompensation;
+    int activeOversamplingIndex = -1;
+    int latencyCompensationSamples = 0;
+    int maxBlockSize = 512;
+    
     // Global frequency range settings
     static constexpr float minFrequency = 20.0f;
     static constexpr float maxFrequency = 30000.0f;
@@ -94,21 +188,136 @@ private:
     // Parameter cache for optimization
     float lastAttack = -1.0f, lastDecay = -1.0f, lastSustain = -1.0f, lastRelease = -1.0f;
     float lastFilterCutoff = -1.0f, lastFilterResonance = -1.0f;
+    int lastWaveform = -1, lastFilterType = -1, lastLfoWaveform = -1, lastMpe = -1;
+    float lastLfoRate = -1.0f, lastLfoDepth = -1.0f;
+    int lastUnisonVoices = -1;
+    float lastUnisonDetune = -1.0f, lastUnisonSpread = -1.0f;
+    bool lastOfflineProfile = false;
+
+    // Binary state: magic, version, then (tag, byte length, payload) sections
+    static constexpr int stateMagic = 0x41444e4b; // "KNDA"
+    static constexpr int stateVersion = 1;
+    static constexpr int parameterSection = 1, midiSection = 2, reverbSection = 3, morphSection = 4, liveSection = 5;
+    void readBinaryState(juce::MemoryInputStream& stream);
+    void applyParameterState(const juce::NamedValueSet& values, int version);
+    void restoreImpulseResponse(const juce::String& path);
+
+    // Offline (non-realtime bounce) quality profile: dense reverb and
+    // band-limited oscillators, plus 8x oversampling with HQ Render on
+    bool offlineProfileActive = false;
+
+    // Preset switching: the message thread posts normalised values; the audio
+    // thread releases voices and fades out over presetFadeSeconds, whatever the
+    // block size. At the first block boundary after silence it writes the snapshot
+    // into the raw parameter values the DSP reads, stops the voices, clears the
+    // tails and fades back in. The parameters themselves (host, automation, UI)
+    // are then set from the message thread by the timer, once that has happened.
+    PresetBank presetBank;
+    int currentProgram = 0;
+    std::vector<juce::RangedAudioParameter*> presetParameters;
+    std::vector<std::atomic<float>*> presetRawValues;
+    juce::StringArray presetParameterIDs;
+    juce::SpinLock presetLock;
+    std::vector<float> pendingPreset, activePreset;
+    std::vector<float> presetScratch, publishedPreset; // Message thread only
+    int presetRequest = 0, publishedPresetRequest = 0; // Message thread: the latest switch posted, and published
+    int pendingPresetRequest = 0, activePresetRequest = 0;
+    std::atomic<int> appliedPresetRequest { 0 };
+    static constexpr int presetPollIntervalMs = 20;
+    bool presetPending = false;
+    bool presetFadingOut = false;
+    static constexpr double presetFadeSeconds = 0.008;
+    juce::SmoothedValue<float> presetGain { 1.0f };
+    void advancePresetSwitch();
+    void applyActivePreset();
+    void timerCallback() override;
+
+    // Morph targets, in the order of morphTargetIDs. The DSP reads morphValues
+    // rather than the raw parameters, so a morph never writes to the parameters
+    // (or moves the sliders) and goes through the same cached update paths.
+    enum MorphTarget
+    {
+        morphAttack, morphDecay, morphSustain, morphRelease,
+        morphFilterCutoff, morphFilterResonance, morphDistortion, morphLfoRate, morphLfoDepth,
+        morphLowShelfFreq, morphLowShelfGain, morphPeak1Freq, morphPeak1Gain, morphPeak1Q,
+        morphPeak3Freq, morphPeak3Gain, morphPeak3Q, morphHighShelfFreq, morphHighShelfGain,
+        morphReverbRoomSize, morphReverbDamping, morphReverbWetLevel, morphReverbDryLevel,
+        numMorphTargets
+    };
+
+    using MorphSnapshot = std::array<float, numMorphTargets>;
+    static constexpr int morphSubBlockSize = 32; // EQ coefficient update interval while the macro moves
+    std::array<std::atomic<float>*, numMorphTargets> morphSources {};
+    std::array<bool, numMorphTargets> logarithmicMorphTargets {};
+    std::atomic<float>* morphParameter = nullptr;
+    std::array<float, numMorphTargets> morphValues {};
+    std::array<float, numMorphTargets> eqCache {}; // Values the EQ coefficients were last built from
+    juce::SmoothedValue<float> morphPosition;
+
+    // Message thread edits pendingSnapshots; the audio thread copies them under a try-lock
+    juce::SpinLock morphLock;
+    std::array<MorphSnapshot, numMorphSnapshots> pendingSnapshots {}, activeSnapshots {};
+    std::array<bool, numMorphSnapshots> pendingStored {}, activeStored {};
+    bool snapshotsChanged = false;
+    std::array<int, numMorphSnapshots> morphPoints {};
+    int numMorphPoints = 0;
+    void updateMorphSnapshots();
+    void updateMorphValues();
+
+    // Randomize glide. The message thread posts a request (under morphLock); the
+    // audio thread captures the current sound and holds it (armed); the timer then
+    // sets the parameters (committed) and the audio thread glides to them.
+    std::vector<std::pair<juce::RangedAudioParameter*, float>> glideParameters; // Message thread only
+    int glideRequest = 0, glideWaitTicks = 0;
+    bool glideRequested = false;
+    int pendingGlideRequest = 0, activeGlideRequest = 0;
+    std::atomic<int> armedGlideRequest { 0 }, committedGlideRequest { 0 };
+    MorphSnapshot glideFrom {};
+    bool glideActive = false;
+    juce::SmoothedValue<float> glideProgress;
+    void startGlide(int request);
+    void applyGlide();
+    void commitGlideParameters();
+
+    // Morphed EQ values published for the editor's curves
+    std::array<std::atomic<float>, numMorphTargets> displayedMorphValues;
+    std::atomic<int> eqDisplayVersion { 0 };
+    void publishEQDisplayValues();
+    void writeMorphSnapshots(juce::MemoryOutputStream& stream);
+    void readMorphSnapshots(juce::MemoryInputStream& stream);
+    void processEQ(juce::AudioBuffer<float>& buffer);
     
-    // Built-in pattern generator
-    bool patternPlaying = false;
-    int patternIndex = 0;
-    int samplesUntilNextNote = 0;
+    // Built-in sequencer. Lane changes are compiled here and posted to the
+    // sequencer, which takes them at the next bar.
+    std::atomic<bool> patternPlaying { false };
+    StepSequencer sequencer;
     const int samplesPerNote = 11025; // 250ms at 44.1kHz (double tempo)
-    std::vector<int> activeNotes;
     int rootKey = 60; // C4 by default
     int currentMode = 0; // Major by default
-    int melodyPattern = 0; // Scale pattern by default
+    PatternLibrary patternLibrary;
+    std::array<int, StepSequencer::numLanes> lanePatterns {};
+    std::array<StepSequencer::LaneSettings, StepSequencer::numLanes> laneSettings {};
+    void applyLaneDefinitions();
+    void postLane(int lane);
+
+    // Live MIDI stage for incoming MIDI, ahead of the octave shift
+    LiveMidiStage liveMidi;
+    juce::MidiBuffer transposedMidi; // Preallocated scratch for the octave shift
+    std::atomic<float>* arpModeParameter = nullptr;
+    std::atomic<float>* arpRateParameter = nullptr;
+    std::atomic<float>* arpOctavesParameter = nullptr;
+    std::atomic<float>* arpGateParameter = nullptr;
+    std::atomic<float>* chordMemoryParameter = nullptr;
+    std::atomic<float>* scaleQuantiseParameter = nullptr;
+    void processLiveMidi(juce::MidiBuffer& midiMessages, int numSamples);
+    void updateLiveScale();
     
     // Audio waveform capture
     static constexpr int waveformSize = 512;
     std::array<float, waveformSize> waveformBuffer;
     int waveformIndex = 0;
+    ScopeCapture scope;
+    MeteringEngine meters;
     
     // FFT analysis
     static constexpr int fftOrder = 10;
@@ -120,11 +329,26 @@ private:
     std::array<float, fftSize / 2> magnitudes;
     std::array<float, fftSize / 2> fftPeakHold; // Slow-decaying peak hold
     int fftDataIndex = 0;
+    std::atomic<int> fftFrameCount { 0 };
+    std::atomic<double> analysisSampleRate { 44100.0 };
     
     void updateSynthParameters();
+    void updateQualityProfile();
+    void updateOversampling();
+    int getOversamplingLatency(int index) const;
+    int getReportedLatency() const;
+
+    // Latency changes are reported from the message thread: the host callbacks
+    // behind setLatencySamples() don't belong on the audio thread
+    void reportLatency();
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void applyOctaveShift(juce::MidiBuffer& midi, int octaveShift, int fixedChannel); // 0 shifts every channel
+    void renderSynthSection(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, juce::MidiBuffer& laneMessages);
+    void applyDistortion(float* const* channels, int numChannels, int numSamples);
     void updateEQParameters();
     void updateReverbParameters();
-    void generateMIDIPattern(juce::MidiBuffer& midiBuffer, int numSamples);
+    int getPatternStepSamples();
     void processFFT(std::array<float, fftSize * 2>& fftData, std::array<float, fftSize / 2>& magnitudes);
     void processFFTWithPeakHold(std::array<float, fftSize * 2>& fftData, std::array<float, fftSize / 2>& magnitudes);
     
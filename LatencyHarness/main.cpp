@@ -0,0 +1,432 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include "../AudioWorkstation/Source/WorkstationProcessor.h"
+#include "../MidiInjector/InjectionEngine.h"
+#include "../Source/CommandLineOptions.h"
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+// End-to-end MIDI-to-audio latency for WorkstationProcessor, with no hardware.
+//
+// The injector engine sends a short note every ~300ms into a MidiMessageCollector
+// (the same path JUCE's standalone host uses for device MIDI). A virtual audio
+// device thread calls processBlock once per buffer period in real time, and the
+// latency of each note is the time from the injector sending it to the first
+// output sample above the threshold being presented, where a block computed in
+// one callback is presented one period later (double buffering).
+//
+// Before that it checks that the live and offline (HQ render) profiles put a
+// note on the same samples: both report the same latency, and their outputs
+// line up best with no offset.
+
+struct LatencyResult
+{
+    int blockSize = 0;
+    double sampleRate = 0.0;
+    int pluginLatencySamples = 0;
+    int missed = 0; // Notes that never produced sound above the threshold
+    std::vector<double> latenciesMs;
+
+    double percentile(double p) const
+    {
+        if (latenciesMs.empty())
+            return 0.0;
+
+        auto sorted = latenciesMs;
+        std::sort(sorted.begin(), sorted.end());
+        auto index = juce::jlimit(0, (int) sorted.size() - 1, (int) std::ceil(p / 100.0 * (double) sorted.size()) - 1);
+        return sorted[(size_t) index];
+    }
+
+    double mean() const
+    {
+        if (latenciesMs.empty())
+            return 0.0;
+
+        return std::accumulate(latenciesMs.begin(), latenciesMs.end(), 0.0) / (double) latenciesMs.size();
+    }
+
+    // Jitter, as the standard deviation of the per-note latency
+    double standardDeviation() const
+    {
+        if (latenciesMs.size() < 2)
+            return 0.0;
+
+        auto average = mean();
+        double sum = 0.0;
+        for (auto latency : latenciesMs)
+            sum += (latency - average) * (latency - average);
+
+        return std::sqrt(sum / (double) (latenciesMs.size() - 1));
+    }
+};
+
+class LatencyRun : private juce::Thread
+{
+public:
+    LatencyRun(double newSampleRate, int newBlockSize, float newThreshold)
+        : juce::Thread("Virtual Audio Device"),
+          sampleRate(newSampleRate), blockSize(newBlockSize), threshold(newThreshold)
+    {
+        // Silence between notes: no reverb tail, short envelope, no built-in patterns
+        auto& parameters = processor.getValueTreeState();
+        parameters.getParameter("attack")->setValueNotifyingHost(0.0f);
+        parameters.getParameter("release")->setValueNotifyingHost(0.0f);
+        parameters.getParameter("reverbWetLevel")->setValueNotifyingHost(0.0f);
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        buffer.setSize(2, blockSize);
+        collector.reset(sampleRate);
+        result.latenciesMs.reserve(4096); // No allocation on the audio thread for any sensible run
+
+        // One short note per loop; the trailing meta event sets the loop length
+        juce::MidiMessageSequence sequence;
+        sequence.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0.0);
+        sequence.addEvent(juce::MidiMessage::noteOff(1, 60, 0.0f), 0.05);
+        sequence.addEvent(juce::MidiMessage::endOfTrack(), noteSpacingSeconds);
+        sequence.updateMatchedPairs();
+        injector.setReplaySequence(sequence);
+
+        injector.setSink([this](const juce::MidiMessage& message)
+        {
+            auto sendTime = InjectionEngine::now();
+
+            if (message.isNoteOn())
+            {
+                const auto scope = onsets.write(1);
+                if (scope.blockSize1 > 0)
+                    onsetTimes[(size_t) scope.startIndex1] = sendTime;
+            }
+
+            auto timestamped = message;
+            timestamped.setTimeStamp(sendTime * 0.001); // The collector works in seconds on the same clock
+            collector.addMessageToQueue(timestamped);
+        });
+    }
+
+    ~LatencyRun() override
+    {
+        injector.stop();
+        stopThread(2000);
+        processor.releaseResources();
+    }
+
+    LatencyResult measure(double seconds)
+    {
+        if (! startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10)))
+            startThread(juce::Thread::Priority::highest);
+
+        InjectionEngine::Settings settings;
+        settings.mode = InjectionEngine::Mode::Replay;
+        injector.start(settings);
+
+        juce::Thread::sleep((int) (seconds * 1000.0));
+
+        injector.stop();
+        juce::Thread::sleep((int) (noteSpacingSeconds * 1000.0)); // Let the last note come through
+        stopThread(2000);
+
+        result.blockSize = blockSize;
+        result.sampleRate = sampleRate;
+        result.pluginLatencySamples = processor.getLatencySamples();
+        result.missed += pendingOnset ? 1 : 0;
+        return result;
+    }
+
+private:
+    static constexpr double noteSpacingSeconds = 0.2973; // Deliberately not a multiple of any buffer period
+
+    WorkstationProcessor processor;
+    InjectionEngine injector;
+    juce::MidiMessageCollector collector;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+
+    double sampleRate;
+    int blockSize;
+    float threshold;
+
+    // Note-on send times, injector thread -> audio thread
+    juce::AbstractFifo onsets { 256 };
+    std::array<double, 256> onsetTimes {};
+
+    // Audio thread only
+    bool pendingOnset = false;
+    double onsetTime = 0.0;
+    LatencyResult result;
+
+    void run() override
+    {
+        auto periodMs = 1000.0 * blockSize / sampleRate;
+        auto nextCallback = InjectionEngine::now();
+
+        while (! threadShouldExit())
+        {
+            // Absolute schedule, like a device clock: a late wake-up doesn't shift later callbacks
+            auto remaining = nextCallback - InjectionEngine::now();
+            if (remaining > 2.0)
+            {
+                wait((int) (remaining - 2.0));
+                continue;
+            }
+
+            if (remaining > 0.0)
+            {
+                juce::Thread::yield();
+                continue;
+            }
+
+            processCallback(nextCallback, periodMs);
+            nextCallback += periodMs;
+        }
+    }
+
+    void processCallback(double callbackTime, double periodMs)
+    {
+        buffer.clear();
+        midi.clear();
+        collector.removeNextBlockOfMessages(midi, blockSize);
+        processor.processBlock(buffer, midi);
+
+        // This block is heard one period after the callback
+        auto presentationTime = callbackTime + periodMs;
+
+        // Notes are far enough apart that the previous one has died away by now
+        if (! pendingOnset && onsets.getNumReady() > 0)
+        {
+            const auto scope = onsets.read(1);
+            onsetTime = onsetTimes[(size_t) scope.startIndex1];
+            pendingOnset = true;
+        }
+
+        for (int sample = 0; pendingOnset && sample < blockSize; ++sample)
+        {
+            auto level = std::abs(buffer.getSample(0, sample));
+            if (buffer.getNumChannels() > 1)
+                level = juce::jmax(level, std::abs(buffer.getSample(1, sample)));
+
+            if (level >= threshold)
+            {
+                result.latenciesMs.push_back(presentationTime + 1000.0 * sample / sampleRate - onsetTime);
+                pendingOnset = false;
+            }
+        }
+
+        // A note still silent after a full spacing period is counted as missed
+        if (pendingOnset && presentationTime - onsetTime > noteSpacingSeconds * 1000.0)
+        {
+            ++result.missed;
+            pendingOnset = false;
+        }
+    }
+};
+
+// One note through a fresh processor in the live or the offline (bounce) profile, with HQ Render on or off
+struct ProfileRender
+{
+    int latencySamples = 0;
+    std::vector<float> samples;
+};
+
+static ProfileRender renderProfile(double sampleRate, int blockSize, bool offline, bool highQuality)
+{
+    static constexpr double renderSeconds = 0.25;
+    static constexpr int noteSample = 37; // Inside the second block, so the note isn't on a block boundary
+
+    WorkstationProcessor processor;
+    auto& parameters = processor.getValueTreeState();
+    parameters.getParameter("renderHighQuality")->setValueNotifyingHost(highQuality ? 1.0f : 0.0f);
+    parameters.getParameter("reverbWetLevel")->setValueNotifyingHost(0.0f);
+
+    processor.setNonRealtime(offline);
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    ProfileRender render;
+
+    auto numBlocks = (int) std::ceil(renderSeconds * sampleRate / blockSize);
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        buffer.clear();
+        midi.clear();
+        if (block == 1)
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), noteSample);
+
+        processor.processBlock(buffer, midi);
+        render.samples.insert(render.samples.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+    }
+
+    render.latencySamples = processor.getLatencySamples();
+    processor.releaseResources();
+    return render;
+}
+
+// The offset of other against reference that correlates best, within +/- maxLag samples
+static int findBestLag(const std::vector<float>& reference, const std::vector<float>& other, int maxLag)
+{
+    auto bestLag = 0;
+    auto bestCorrelation = -std::numeric_limits<double>::max();
+
+    for (int lag = -maxLag; lag <= maxLag; ++lag)
+    {
+        double correlation = 0.0;
+        for (int i = juce::jmax(0, -lag); i < (int) reference.size() && i + lag < (int) other.size(); ++i)
+            correlation += (double) reference[(size_t) i] * other[(size_t) (i + lag)];
+
+        if (correlation > bestCorrelation)
+        {
+            bestCorrelation = correlation;
+            bestLag = lag;
+        }
+    }
+
+    return bestLag;
+}
+
+// False when switching to the offline profile would move a note in time
+static bool checkProfileTiming(double sampleRate)
+{
+    // Well under half a period of the test note, so the peak can't skip a cycle
+    static constexpr int maxLag = 64;
+    static constexpr int blockSize = 512;
+
+    auto aligned = true;
+
+    // With HQ Render off (the default) and on
+    for (auto highQuality : { false, true })
+    {
+        auto live = renderProfile(sampleRate, blockSize, false, highQuality);
+        auto offline = renderProfile(sampleRate, blockSize, true, highQuality);
+        auto lag = findBestLag(live.samples, offline.samples, maxLag);
+
+        std::cerr << "Live/offline profile timing (HQ Render " << (highQuality ? "on" : "off") << "): latency "
+                  << live.latencySamples << "/" << offline.latencySamples
+                  << " samples, best alignment at " << lag << " samples\n";
+
+        aligned = aligned && live.latencySamples == offline.latencySamples && lag == 0;
+    }
+
+    return aligned;
+}
+
+static juce::String toCsv(const std::vector<LatencyResult>& results)
+{
+    juce::String csv = "buffer_size,sample_rate,buffer_ms,plugin_latency_samples,notes,missed,"
+                       "mean_ms,jitter_stddev_ms,min_ms,p50_ms,p99_ms,max_ms\n";
+
+    for (auto& result : results)
+    {
+        csv << result.blockSize << "," << result.sampleRate << ","
+            << juce::String(1000.0 * result.blockSize / result.sampleRate, 3) << ","
+            << result.pluginLatencySamples << "," << (int) result.latenciesMs.size() << "," << result.missed << ","
+            << juce::String(result.mean(), 3) << "," << juce::String(result.standardDeviation(), 3) << ","
+            << juce::String(result.percentile(0.0), 3) << "," << juce::String(result.percentile(50.0), 3) << ","
+            << juce::String(result.percentile(99.0), 3) << "," << juce::String(result.percentile(100.0), 3) << "\n";
+    }
+
+    return csv;
+}
+
+static juce::String toJson(const std::vector<LatencyResult>& results)
+{
+    juce::Array<juce::var> entries;
+
+    for (auto& result : results)
+    {
+        auto entry = std::make_unique<juce::DynamicObject>();
+        entry->setProperty("bufferSize", result.blockSize);
+        entry->setProperty("sampleRate", result.sampleRate);
+        entry->setProperty("bufferMs", 1000.0 * result.blockSize / result.sampleRate);
+        entry->setProperty("pluginLatencySamples", result.pluginLatencySamples);
+        entry->setProperty("notes", (int) result.latenciesMs.size());
+        entry->setProperty("missed", result.missed);
+        entry->setProperty("meanMs", result.mean());
+        entry->setProperty("jitterStdDevMs", result.standardDeviation());
+        entry->setProperty("minMs", result.percentile(0.0));
+        entry->setProperty("p50Ms", result.percentile(50.0));
+        entry->setProperty("p99Ms", result.percentile(99.0));
+        entry->setProperty("maxMs", result.percentile(100.0));
+
+        juce::Array<juce::var> latencies;
+        for (auto latency : result.latenciesMs)
+            latencies.add(latency);
+        entry->setProperty("latenciesMs", latencies);
+
+        entries.add(juce::var(entry.release()));
+    }
+
+    return juce::JSON::toString(juce::var(entries));
+}
+
+// Options (values as "--option value" or "--option=value"):
+//   --buffers 32,64,128,256,512,1024   buffer sizes to test
+//   --rate 48000                       sample rate
+//   --seconds 5                        measurement time per buffer size
+//   --threshold 0.00001                first "nonzero" level (-100dB)
+//   --csv FILE / --json FILE           report destinations (CSV to stdout otherwise)
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    auto bufferList = CommandLineOptions::getValue(args, "--buffers");
+    auto bufferSizes = juce::StringArray::fromTokens(bufferList.isNotEmpty() ? bufferList : "32,64,128,256,512,1024", ",", "");
+    auto sampleRate = CommandLineOptions::getDouble(args, "--rate", 48000.0);
+    auto seconds = CommandLineOptions::getDouble(args, "--seconds", 5.0);
+    auto threshold = (float) CommandLineOptions::getDouble(args, "--threshold", 1.0e-5);
+
+    // Every ms/sample conversion divides by these
+    if (sampleRate <= 0.0 || seconds <= 0.0 || threshold <= 0.0f)
+    {
+        std::cerr << "--rate, --seconds and --threshold need positive values\n";
+        return 2;
+    }
+
+    // Fail CI if a bounce wouldn't land on the same samples as live playback
+    if (! checkProfileTiming(sampleRate))
+        return 1;
+
+    std::vector<LatencyResult> results;
+
+    for (auto& size : bufferSizes)
+    {
+        auto blockSize = size.getIntValue();
+        if (blockSize <= 0)
+            continue;
+
+        std::cerr << "Measuring " << blockSize << " samples at " << sampleRate << "Hz...\n";
+
+        LatencyRun latencyRun(sampleRate, blockSize, threshold);
+        results.push_back(latencyRun.measure(seconds));
+    }
+
+    auto csv = toCsv(results);
+    auto csvPath = CommandLineOptions::getValue(args, "--csv");
+    auto jsonPath = CommandLineOptions::getValue(args, "--json");
+
+    if (csvPath.isNotEmpty() && ! juce::File::getCurrentWorkingDirectory().getChildFile(csvPath).replaceWithText(csv))
+    {
+        std::cerr << "Couldn't write " << csvPath << "\n";
+        return 2;
+    }
+
+    if (jsonPath.isNotEmpty() && ! juce::File::getCurrentWorkingDirectory().getChildFile(jsonPath).replaceWithText(toJson(results)))
+    {
+        std::cerr << "Couldn't write " << jsonPath << "\n";
+        return 2;
+    }
+
+    if (csvPath.isEmpty() && jsonPath.isEmpty())
+        std::cout << csv;
+
+    // Fail CI if any buffer size produced no measurements at all
+    for (auto& result : results)
+        if (result.latenciesMs.empty())
+            return 1;
+
+    return 0;
+}
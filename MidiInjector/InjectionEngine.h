@@ -0,0 +1,451 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// How late each message left compared with its scheduled time. Written only by
+// the injector thread; the counters are atomics so a UI or the console can read
+// them while it runs.
+class JitterHistogram
+{
+public:
+    static constexpr double binWidthMs = 0.05;
+    static constexpr int numBins = 400; // 0-20ms; the last bin also collects anything later
+
+    void reset()
+    {
+        for (auto& bin : bins)
+            bin.store(0);
+
+        count.store(0);
+        totalMs.store(0.0);
+        maxMs.store(0.0);
+    }
+
+    void record(double latenessMs)
+    {
+        latenessMs = juce::jmax(0.0, latenessMs);
+        auto bin = juce::jmin(numBins - 1, (int) (latenessMs / binWidthMs));
+
+        bins[(size_t) bin].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        // Single writer, so plain load/store is enough for the doubles
+        totalMs.store(totalMs.load(std::memory_order_relaxed) + latenessMs, std::memory_order_relaxed);
+        if (latenessMs > maxMs.load(std::memory_order_relaxed))
+            maxMs.store(latenessMs, std::memory_order_relaxed);
+    }
+
+    juce::int64 getCount() const { return count.load(); }
+    double getMaxMs() const { return maxMs.load(); }
+
+    // Messages at or beyond the given lateness (to bin resolution)
+    juce::int64 getCountAtOrAbove(double latenessMs) const
+    {
+        juce::int64 total = 0;
+        for (int i = juce::jmin(numBins - 1, (int) (latenessMs / binWidthMs)); i < numBins; ++i)
+            total += bins[(size_t) i].load();
+
+        return total;
+    }
+
+    double getMeanMs() const
+    {
+        auto n = count.load();
+        return n > 0 ? totalMs.load() / (double) n : 0.0;
+    }
+
+    // Upper edge of the bin holding the given percentile (0-100)
+    double getPercentileMs(double percentile) const
+    {
+        auto n = count.load();
+        if (n == 0)
+            return 0.0;
+
+        auto target = (juce::int64) std::ceil((double) n * percentile / 100.0);
+        juce::int64 seen = 0;
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            seen += bins[(size_t) i].load();
+            if (seen >= target)
+                return (i + 1) * binWidthMs;
+        }
+
+        return getMaxMs();
+    }
+
+    juce::String getSummary() const
+    {
+        return "sent " + juce::String(getCount())
+             + ", late by mean " + juce::String(getMeanMs(), 3) + "ms"
+             + ", p50 " + juce::String(getPercentileMs(50.0), 2) + "ms"
+             + ", p99 " + juce::String(getPercentileMs(99.0), 2) + "ms"
+             + ", max " + juce::String(getMaxMs(), 3) + "ms";
+    }
+
+    // One "from-to ms: count" line per non-empty bin
+    juce::String getTable() const
+    {
+        juce::String table;
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            auto binCount = bins[(size_t) i].load();
+            if (binCount == 0)
+                continue;
+
+            table << juce::String(i * binWidthMs, 2) << "-"
+                  << (i == numBins - 1 ? juce::String("inf") : juce::String((i + 1) * binWidthMs, 2))
+                  << " ms: " << binCount << "\n";
+        }
+
+        return table;
+    }
+
+private:
+    std::array<std::atomic<juce::int64>, numBins> bins {};
+    std::atomic<juce::int64> count { 0 };
+    std::atomic<double> totalMs { 0.0 }, maxMs { 0.0 };
+};
+
+// Plays the injector's test pattern, a stress load or a replayed MIDI file from
+// its own high-priority thread. Events are scheduled in absolute time on the
+// monotonic hi-res millisecond counter, so a late wake-up never pushes later
+// notes back, and the message thread (and anything loading the GUI) is never
+// involved in timing.
+class InjectionEngine : private juce::Thread
+{
+public:
+    enum class Mode
+    {
+        Scale = 0,  // The original C major scale test pattern
+        Stress,     // Configurable note density plus controller floods
+        Replay      // A loaded MIDI file, looped
+    };
+
+    struct Settings
+    {
+        Mode mode = Mode::Scale;
+        int channel = 1;
+
+        // Scale pattern
+        double noteIntervalMs = 500.0;
+        double noteLengthMs = 400.0;
+        double chordDelayMs = 100.0;   // Every 4th note is followed by a C major triad
+        double chordLengthMs = 300.0;
+
+        // Stress load; any rate can be zero. Notes are random between lowestNote and highestNote.
+        double notesPerSecond = 1000.0;  // Note-on events per second (each may be a chord)
+        int chordSize = 1;
+        double stressNoteLengthMs = 50.0;
+        int lowestNote = 36, highestNote = 96;
+        double controllersPerSecond = 0.0;
+        double pitchBendsPerSecond = 0.0;
+        double aftertouchPerSecond = 0.0;
+
+        // Replay. With a sample rate set, event times are snapped to that rate's
+        // sample grid (loop length included), so a replay lands on the same sample
+        // offsets as an offline render of the file at that rate.
+        double replaySpeed = 1.0;
+        double replaySampleRate = 0.0;
+    };
+
+    // Called on the injector thread for every message, e.g. MidiOutput::sendMessageNow
+    using Sink = std::function<void(const juce::MidiMessage&)>;
+
+    InjectionEngine() : juce::Thread("MIDI Injector") {}
+
+    ~InjectionEngine() override
+    {
+        stop();
+    }
+
+    // Only while stopped
+    void setSink(Sink newSink)
+    {
+        jassert(! isThreadRunning());
+        sink = std::move(newSink);
+    }
+
+    bool start(const Settings& newSettings)
+    {
+        stop();
+
+        if (sink == nullptr)
+            return false;
+
+        settings = newSettings;
+        histogram.reset();
+
+        // Realtime scheduling where the OS allows it, otherwise the highest normal priority
+        return startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10))
+            || startThread(juce::Thread::Priority::highest);
+    }
+
+    void stop()
+    {
+        stopThread(2000);
+    }
+
+    // Only while stopped. Note-offs should be matched (MidiMessageSequence::updateMatchedPairs).
+    void setReplaySequence(const juce::MidiMessageSequence& sequence)
+    {
+        jassert(! isThreadRunning());
+        replaySequence = sequence;
+        replaySequence.sort();
+    }
+
+    bool isRunning() const { return isThreadRunning(); }
+    const JitterHistogram& getHistogram() const { return histogram; }
+
+    static double now() { return juce::Time::getMillisecondCounterHiRes(); }
+
+private:
+    static constexpr double lookaheadMs = 50.0;    // How far ahead the pattern is expanded into events
+    static constexpr double spinThresholdMs = 2.0; // Sleeps overshoot, so the last stretch is yielded through
+
+    struct Event
+    {
+        double timeMs;
+        juce::int64 order; // Keeps events with the same time in the order they were added
+        juce::MidiMessage message;
+    };
+
+    struct Later
+    {
+        bool operator()(const Event& a, const Event& b) const
+        {
+            return a.timeMs != b.timeMs ? a.timeMs > b.timeMs : a.order > b.order;
+        }
+    };
+
+    Sink sink;
+    Settings settings;
+    JitterHistogram histogram;
+
+    std::priority_queue<Event, std::vector<Event>, Later> schedule;
+    juce::int64 eventsAdded = 0;
+    std::array<std::bitset<128>, 16> heldNotes; // Per channel: a replayed file can use any of them
+    juce::Random random;
+
+    // Generator state, all in absolute milliseconds
+    int patternIndex = 0;
+    double nextNoteTime = 0.0, nextControllerTime = 0.0, nextPitchBendTime = 0.0, nextAftertouchTime = 0.0;
+    juce::MidiMessageSequence replaySequence;
+    int replayIndex = 0;
+    double replayStartTime = 0.0;
+    double generatedUntil = 0.0;
+
+    void run() override
+    {
+        schedule = {};
+        for (auto& channelNotes : heldNotes)
+            channelNotes.reset();
+        patternIndex = 0;
+        replayIndex = 0;
+
+        auto startTime = now();
+        nextNoteTime = startTime + (settings.mode == Mode::Scale ? settings.noteIntervalMs : 0.0);
+        nextControllerTime = nextPitchBendTime = nextAftertouchTime = replayStartTime = startTime;
+        generatedUntil = startTime;
+
+        while (! threadShouldExit())
+        {
+            // Keep the schedule topped up slightly ahead of the clock
+            generate(now() + lookaheadMs);
+
+            auto due = schedule.empty() ? generatedUntil - lookaheadMs : schedule.top().timeMs;
+
+            if (! waitUntil(due))
+                break;
+
+            // Everything that's due goes out now; lateness is measured per message
+            while (! schedule.empty() && schedule.top().timeMs <= now())
+            {
+                auto event = schedule.top();
+                schedule.pop();
+                send(event.message);
+                histogram.record(now() - event.timeMs);
+            }
+        }
+
+        // Don't leave anything hanging on the receiver, on whichever channel it was started
+        for (int channel = 1; channel <= 16; ++channel)
+            for (int note = 0; note < 128; ++note)
+                if (heldNotes[(size_t) channel - 1][(size_t) note])
+                    send(juce::MidiMessage::noteOff(channel, note, 0.0f));
+    }
+
+    bool waitUntil(double targetMs)
+    {
+        for (;;)
+        {
+            if (threadShouldExit())
+                return false;
+
+            auto remaining = targetMs - now();
+            if (remaining <= 0.0)
+                return true;
+
+            if (remaining > spinThresholdMs)
+                wait((int) (remaining - spinThresholdMs));
+            else
+                juce::Thread::yield();
+        }
+    }
+
+    void send(const juce::MidiMessage& message)
+    {
+        auto& channelNotes = heldNotes[(size_t) juce::jlimit(1, 16, message.getChannel()) - 1];
+
+        if (message.isNoteOn())
+            channelNotes.set((size_t) message.getNoteNumber());
+        else if (message.isNoteOff())
+            channelNotes.reset((size_t) message.getNoteNumber());
+
+        sink(message);
+    }
+
+    void addEvent(double timeMs, const juce::MidiMessage& message)
+    {
+        schedule.push({ timeMs, eventsAdded++, message });
+    }
+
+    void generate(double untilMs)
+    {
+        switch (settings.mode)
+        {
+            case Mode::Scale:
+                while (nextNoteTime <= untilMs)
+                {
+                    schedulePattern(nextNoteTime);
+                    nextNoteTime += settings.noteIntervalMs;
+                }
+                break;
+
+            case Mode::Stress:
+                generateStress(untilMs);
+                break;
+
+            case Mode::Replay:
+                generateReplay(untilMs);
+                break;
+        }
+
+        generatedUntil = untilMs;
+    }
+
+    // Evenly spaced events at each configured rate, with random content
+    void generateStress(double untilMs)
+    {
+        auto channel = settings.channel;
+        auto noteRange = juce::jmax(1, settings.highestNote - settings.lowestNote + 1);
+
+        if (settings.notesPerSecond > 0.0)
+        {
+            for (; nextNoteTime <= untilMs; nextNoteTime += 1000.0 / settings.notesPerSecond)
+            {
+                for (int i = 0; i < juce::jmax(1, settings.chordSize); ++i)
+                {
+                    auto note = settings.lowestNote + random.nextInt(noteRange);
+                    addEvent(nextNoteTime, juce::MidiMessage::noteOn(channel, note, (juce::uint8) (1 + random.nextInt(127))));
+                    addEvent(nextNoteTime + settings.stressNoteLengthMs, juce::MidiMessage::noteOff(channel, note, 0.0f));
+                }
+            }
+        }
+
+        if (settings.controllersPerSecond > 0.0)
+        {
+            // Mod wheel, volume, pan, expression and cutoff - the ones synths usually respond to
+            static const int controllers[] = { 1, 7, 10, 11, 74 };
+
+            for (; nextControllerTime <= untilMs; nextControllerTime += 1000.0 / settings.controllersPerSecond)
+                addEvent(nextControllerTime, juce::MidiMessage::controllerEvent(channel, controllers[random.nextInt(5)], random.nextInt(128)));
+        }
+
+        if (settings.pitchBendsPerSecond > 0.0)
+        {
+            // A continuous 2Hz sweep, the densest realistic bend stream
+            for (; nextPitchBendTime <= untilMs; nextPitchBendTime += 1000.0 / settings.pitchBendsPerSecond)
+            {
+                auto phase = std::sin(nextPitchBendTime * 0.002 * juce::MathConstants<double>::twoPi);
+                addEvent(nextPitchBendTime, juce::MidiMessage::pitchWheel(channel, juce::jlimit(0, 16383, 8192 + (int) (phase * 8191.0))));
+            }
+        }
+
+        if (settings.aftertouchPerSecond > 0.0)
+        {
+            for (; nextAftertouchTime <= untilMs; nextAftertouchTime += 1000.0 / settings.aftertouchPerSecond)
+                addEvent(nextAftertouchTime, juce::MidiMessage::channelPressureChange(channel, random.nextInt(128)));
+        }
+    }
+
+    // Loops the sequence; its timestamps are in seconds
+    void generateReplay(double untilMs)
+    {
+        auto numEvents = replaySequence.getNumEvents();
+        if (numEvents == 0)
+            return;
+
+        auto speed = juce::jmax(0.01, settings.replaySpeed);
+        auto lengthMs = juce::jmax(1.0, toReplayTimeMs(replaySequence.getEndTime(), speed));
+
+        for (;;)
+        {
+            if (replayIndex >= numEvents)
+            {
+                replayIndex = 0;
+                replayStartTime += lengthMs;
+            }
+
+            auto& message = replaySequence.getEventPointer(replayIndex)->message;
+            auto timeMs = replayStartTime + toReplayTimeMs(message.getTimeStamp(), speed);
+
+            if (timeMs > untilMs)
+                break;
+
+            // Meta events (tempo, track names) aren't sent to a port
+            if (! message.isMetaEvent())
+                addEvent(timeMs, message);
+
+            ++replayIndex;
+        }
+    }
+
+    double toReplayTimeMs(double seconds, double speed) const
+    {
+        auto sampleRate = settings.replaySampleRate;
+        if (sampleRate <= 0.0)
+            return seconds * 1000.0 / speed;
+
+        return std::round(seconds * sampleRate / speed) * 1000.0 / sampleRate;
+    }
+
+    // C major scale with varying velocity, plus a triad after every 4th note
+    void schedulePattern(double timeMs)
+    {
+        static const int notes[] = { 60, 62, 64, 65, 67, 69, 71, 72 };
+        static const float velocities[] = { 0.8f, 0.6f, 0.9f, 0.7f, 0.85f, 0.75f, 0.65f, 1.0f };
+
+        auto note = notes[patternIndex % 8];
+        addEvent(timeMs, juce::MidiMessage::noteOn(settings.channel, note, velocities[patternIndex % 8]));
+        addEvent(timeMs + settings.noteLengthMs, juce::MidiMessage::noteOff(settings.channel, note, 0.0f));
+
+        if (++patternIndex % 4 == 0)
+        {
+            auto chordTime = timeMs + settings.chordDelayMs;
+
+            for (auto chordNote : { 60, 64, 67 })
+            {
+                addEvent(chordTime, juce::MidiMessage::noteOn(settings.channel, chordNote, 0.6f));
+                addEvent(chordTime + settings.chordLengthMs, juce::MidiMessage::noteOff(settings.channel, chordNote, 0.0f));
+            }
+        }
+    }
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include "InjectionEngine.h"
+
+// In-process stand-in for a MIDI port. The injector pushes into a bounded FIFO
+// the way a driver fills its input buffer, and a consumer thread drains it once
+// per simulated audio block, as a host's audio callback would. Messages that
+// don't fit are dropped and counted; the delay from push to drain is recorded
+// in a histogram alongside the injector's own send jitter.
+class MidiLoopback : private juce::Thread
+{
+public:
+    explicit MidiLoopback(int capacity = 4096)
+        : juce::Thread("MIDI Loopback"), fifo(capacity), slots((size_t) capacity)
+    {
+    }
+
+    ~MidiLoopback() override
+    {
+        stop();
+    }
+
+    // blockMs is the simulated audio callback period, e.g. 512 samples at 48kHz = 10.67ms
+    bool start(double newBlockMs)
+    {
+        stop();
+
+        blockMs = juce::jmax(0.1, newBlockMs);
+        fifo.reset();
+        pushed.store(0);
+        dropped.store(0);
+        received.store(0);
+        delivery.reset();
+
+        return startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(9))
+            || startThread(juce::Thread::Priority::high);
+    }
+
+    void stop()
+    {
+        stopThread(2000);
+    }
+
+    // Producer side (the injector thread only)
+    void push(const juce::MidiMessage& message)
+    {
+        pushed.fetch_add(1, std::memory_order_relaxed);
+
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto& slot = slots[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        slot = message;
+        slot.setTimeStamp(InjectionEngine::now());
+    }
+
+    InjectionEngine::Sink getSink()
+    {
+        return [this](const juce::MidiMessage& message) { push(message); };
+    }
+
+    juce::int64 getPushed() const { return pushed.load(); }
+    juce::int64 getDropped() const { return dropped.load(); }
+    juce::int64 getReceived() const { return received.load(); }
+    const JitterHistogram& getDeliveryHistogram() const { return delivery; }
+
+    juce::String getSummary() const
+    {
+        return "received " + juce::String(getReceived()) + " of " + juce::String(getPushed())
+             + ", dropped " + juce::String(getDropped())
+             + ", delivery delay mean " + juce::String(delivery.getMeanMs(), 2) + "ms"
+             + ", p99 " + juce::String(delivery.getPercentileMs(99.0), 2) + "ms"
+             + ", max " + juce::String(delivery.getMaxMs(), 2) + "ms";
+    }
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<juce::MidiMessage> slots;
+    double blockMs = 10.0;
+
+    std::atomic<juce::int64> pushed { 0 }, dropped { 0 }, received { 0 };
+    JitterHistogram delivery;
+
+    void run() override
+    {
+        auto nextBlock = InjectionEngine::now() + blockMs;
+
+        while (! threadShouldExit())
+        {
+            auto remaining = nextBlock - InjectionEngine::now();
+            if (remaining > 0.0)
+            {
+                wait(juce::jmax(1, (int) remaining));
+                continue;
+            }
+
+            nextBlock += blockMs;
+            drain();
+        }
+
+        drain();
+    }
+
+    void drain()
+    {
+        auto drainTime = InjectionEngine::now();
+        const auto scope = fifo.read(fifo.getNumReady());
+
+        scope.forEach([this, drainTime](int index)
+        {
+            delivery.record(drainTime - slots[(size_t) index].getTimeStamp());
+            received.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+};
@@ -1,14 +1,139 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_events/juce_events.h>
 #include <juce_audio_devices/juce_audio_devices.h>
+#include "InjectionEngine.h"
+#include "MidiLoopback.h"
+#include "../Source/MidiFileIO.h"
+#include "../Source/CommandLineOptions.h"
 #include <iostream>
-#include <thread>
-#include <chrono>
 
-class MidiInjector : public juce::Timer
+class MidiInjector
 {
 public:
-    MidiInjector()
+    MidiInjector(const juce::ArgumentList& args)
+    {
+        auto settings = parseSettings(args);
+        lateThresholdMs = optionValue(args, "--late", 1.0);
+
+        if (args.containsOption("--loopback"))
+        {
+            // In-process port drained once per simulated audio block
+            auto blockMs = optionValue(args, "--loopback", 512.0 / 48.0);
+            loopback = std::make_unique<MidiLoopback>();
+            loopback->start(blockMs);
+            engine.setSink(loopback->getSink());
+            std::cout << "Using in-process loopback, drained every " << blockMs << "ms\n";
+        }
+        else if (openOutput())
+        {
+            // Timing runs on the engine's own thread, sending straight to the device
+            engine.setSink([output = midiOutput.get()](const juce::MidiMessage& message)
+            {
+                output->sendMessageNow(message);
+            });
+        }
+        else
+        {
+            return;
+        }
+
+        describe(settings);
+
+        if (!engine.start(settings))
+            std::cerr << "Failed to start the injector thread\n";
+    }
+    
+    ~MidiInjector()
+    {
+        // Stopping the engine releases any notes it still holds
+        engine.stop();
+        if (loopback)
+            loopback->stop();
+    }
+
+    // One line, suitable for printing every second during a run
+    juce::String getStatus() const
+    {
+        auto& histogram = engine.getHistogram();
+        auto status = histogram.getSummary()
+                    + ", " + juce::String(histogram.getCountAtOrAbove(lateThresholdMs))
+                    + " late (>= " + juce::String(lateThresholdMs, 1) + "ms)";
+
+        if (loopback)
+            status << "\n  loopback: " << loopback->getSummary();
+
+        return status;
+    }
+
+    const JitterHistogram& getHistogram() const { return engine.getHistogram(); }
+    
+private:
+    static double optionValue(const juce::ArgumentList& args, const char* option, double defaultValue)
+    {
+        return CommandLineOptions::getDouble(args, option, defaultValue);
+    }
+
+    InjectionEngine::Settings parseSettings(const juce::ArgumentList& args)
+    {
+        InjectionEngine::Settings settings;
+        settings.noteIntervalMs = 2000.0; // A note every 2 seconds
+        settings.noteLengthMs = 500.0;
+        settings.chordDelayMs = 100.0;
+        settings.chordLengthMs = 800.0;
+
+        if (args.containsOption("--stress"))
+        {
+            settings.mode = InjectionEngine::Mode::Stress;
+            settings.notesPerSecond = optionValue(args, "--rate", 1000.0);
+            settings.chordSize = (int) optionValue(args, "--chord", 1.0);
+            settings.stressNoteLengthMs = optionValue(args, "--length", 50.0);
+            settings.controllersPerSecond = optionValue(args, "--cc", 0.0);
+            settings.pitchBendsPerSecond = optionValue(args, "--bend", 0.0);
+            settings.aftertouchPerSecond = optionValue(args, "--aftertouch", 0.0);
+        }
+
+        auto smfPath = CommandLineOptions::getValue(args, "--smf");
+        if (smfPath.isNotEmpty())
+        {
+            // Type 0 or 1, all tracks merged into one timeline in seconds
+            juce::MidiMessageSequence sequence;
+            int fileType = 0, numTracks = 0;
+
+            if (MidiFileIO::read(juce::File::getCurrentWorkingDirectory().getChildFile(smfPath), sequence, &fileType, &numTracks))
+            {
+                engine.setReplaySequence(sequence);
+                settings.mode = InjectionEngine::Mode::Replay;
+                settings.replaySpeed = optionValue(args, "--speed", 1.0);
+                settings.replaySampleRate = optionValue(args, "--sample-rate", 0.0);
+                std::cout << "Loaded type " << fileType << " MIDI file, " << numTracks << " track(s), "
+                          << sequence.getNumEvents() << " events, " << sequence.getEndTime() << "s\n";
+            }
+            else
+            {
+                std::cerr << "Couldn't read MIDI file " << smfPath << ", playing the scale instead\n";
+            }
+        }
+
+        return settings;
+    }
+
+    void describe(const InjectionEngine::Settings& settings)
+    {
+        std::cout << "Starting MIDI injection...\n";
+
+        if (settings.mode == InjectionEngine::Mode::Stress)
+            std::cout << "Stress: " << settings.notesPerSecond << " notes/s x" << settings.chordSize
+                      << ", " << settings.controllersPerSecond << " CC/s, " << settings.pitchBendsPerSecond
+                      << " bends/s, " << settings.aftertouchPerSecond << " aftertouch/s\n";
+        else if (settings.mode == InjectionEngine::Mode::Replay)
+            std::cout << "Replaying MIDI file at " << settings.replaySpeed << "x"
+                      << (settings.replaySampleRate > 0.0 ? ", on the " + juce::String(settings.replaySampleRate, 0) + "Hz sample grid" : juce::String())
+                      << "\n";
+        else
+            std::cout << "Playing C major scale pattern\n";
+    }
+
+    bool openOutput()
     {
         // Find available MIDI output devices
         auto midiOutputs = juce::MidiOutput::getAvailableDevices();
@@ -42,112 +167,55 @@ public:
         if (!midiOutput)
         {
             std::cerr << "Failed to create MIDI output device\n";
-            return;
-        }
-        
-        std::cout << "Starting MIDI injection...\n";
-        std::cout << "Playing C major scale pattern\n";
-        std::cout << "Press Ctrl+C to stop\n";
-        
-        startTimer(2000); // Start playing every 2 seconds
-    }
-    
-    ~MidiInjector()
-    {
-        stopTimer();
-        if (midiOutput)
-        {
-            // Send all notes off
-            for (int note = 0; note < 128; ++note)
-            {
-                midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, note, 0.0f));
-            }
-        }
-    }
-    
-    void timerCallback() override
-    {
-        if (!midiOutput)
-            return;
-            
-        playPattern();
-    }
-    
-private:
-    void playPattern()
-    {
-        // C major scale: C, D, E, F, G, A, B, C
-        static const int notes[] = {60, 62, 64, 65, 67, 69, 71, 72}; // MIDI note numbers
-        static const float velocities[] = {0.8f, 0.6f, 0.9f, 0.7f, 0.85f, 0.75f, 0.65f, 1.0f};
-        static int patternIndex = 0;
-        
-        int note = notes[patternIndex % 8];
-        float velocity = velocities[patternIndex % 8];
-        
-        std::cout << "Playing note " << note << " (velocity " << velocity << ")\n";
-        
-        // Send note on
-        midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, note, velocity));
-        
-        // Schedule note off after 500ms
-        juce::Timer::callAfterDelay(500, [this, note]()
-        {
-            if (midiOutput)
-            {
-                midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, note, 0.0f));
-            }
-        });
-        
-        patternIndex++;
-        
-        // Add some variation - occasionally play chords
-        if (patternIndex % 4 == 0)
-        {
-            // Play a C major triad
-            juce::Timer::callAfterDelay(100, [this]()
-            {
-                if (midiOutput)
-                {
-                    std::cout << "Playing C major chord\n";
-                    midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, 60, 0.6f)); // C
-                    midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, 64, 0.6f)); // E
-                    midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, 67, 0.6f)); // G
-                    
-                    juce::Timer::callAfterDelay(800, [this]()
-                    {
-                        if (midiOutput)
-                        {
-                            midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, 60, 0.0f));
-                            midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, 64, 0.0f));
-                            midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, 67, 0.0f));
-                        }
-                    });
-                }
-            });
+            return false;
         }
+
+        return true;
     }
-    
+
+    // Declared first so the engine (and its thread) is gone before the outputs close
     std::unique_ptr<juce::MidiOutput> midiOutput;
+    std::unique_ptr<MidiLoopback> loopback;
+    InjectionEngine engine;
+    double lateThresholdMs = 1.0;
 };
 
 class MidiInjectorApp
 {
 public:
-    int run()
+    int run(const juce::ArgumentList& args)
     {
         // Initialize JUCE
         juce::initialiseJuce_GUI();
         
-        injector = std::make_unique<MidiInjector>();
+        injector = std::make_unique<MidiInjector>(args);
         
         std::cout << "\nMIDI Injector running...\n";
         std::cout << "This will send MIDI notes to test your SineSynth\n";
         std::cout << "Make sure SineSynth standalone is running\n";
-        std::cout << "Press Enter to quit\n\n";
-        
-        // Wait for user input
-        std::cin.get();
+
+        auto seconds = (int) CommandLineOptions::getDouble(args, "--seconds", 0.0);
+        if (seconds > 0)
+        {
+            // Timed run with a status line every second
+            for (int i = 0; i < seconds; ++i)
+            {
+                juce::Thread::sleep(1000);
+                std::cout << injector->getStatus() << "\n";
+            }
+        }
+        else
+        {
+            std::cout << "Press Enter to quit\n\n";
+            
+            // Wait for user input
+            std::cin.get();
+        }
         
+        // How far behind schedule messages actually went out
+        std::cout << "Send timing: " << injector->getStatus() << "\n";
+        std::cout << injector->getHistogram().getTable();
+
         injector.reset();
         juce::shutdownJuce_GUI();
         
@@ -158,8 +226,15 @@ private:
     std::unique_ptr<MidiInjector> injector;
 };
 
-int main()
+// Options (values as "--option value" or "--option=value"):
+//   --stress [--rate N] [--chord N] [--length MS] [--cc N] [--bend N] [--aftertouch N]
+//   --smf FILE [--speed X]      replay a type 0/1 MIDI file in a loop
+//     [--sample-rate HZ]        snap replayed events to that rate's sample grid
+//   --loopback [BLOCK_MS]       in-process port instead of a device, reports drops
+//   --late MS                   lateness counted as late (default 1ms)
+//   --seconds N                 run for N seconds instead of until Enter
+int main(int argc, char* argv[])
 {
     MidiInjectorApp app;
-    return app.run();
+    return app.run(juce::ArgumentList(argc, argv));
 }
\ No newline at end of file
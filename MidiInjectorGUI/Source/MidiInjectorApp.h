@@ -3,6 +3,7 @@
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_events/juce_events.h>
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "../../MidiInjector/InjectionEngine.h"
 
 class MidiInjectorComponent : public juce::Component, public juce::Timer
 {
@@ -16,8 +17,11 @@ public:
         startButton.onClick = [this] { startInjection(); };
         stopButton.onClick = [this] { stopInjection(); };
         
+        stressButton.setButtonText("Stress load (1000 notes/s, CC, bend and aftertouch floods)");
+
         addAndMakeVisible(startButton);
         addAndMakeVisible(stopButton);
+        addAndMakeVisible(stressButton);
         addAndMakeVisible(statusLabel);
         
         stopButton.setEnabled(false);
@@ -27,18 +31,23 @@ public:
         if (midiOutput)
         {
             statusLabel.setText("MIDI device 'SineSynth MIDI Injector' created", juce::dontSendNotification);
+            engine.setSink([output = midiOutput.get()](const juce::MidiMessage& message)
+            {
+                output->sendMessageNow(message);
+            });
         }
         else
         {
             statusLabel.setText("Failed to create MIDI device", juce::dontSendNotification);
         }
         
-        setSize(400, 150);
+        setSize(400, 200);
     }
     
-    ~MidiInjectorComponent()
+    ~MidiInjectorComponent() override
     {
         stopTimer();
+        engine.stop();
     }
     
     void resized() override
@@ -47,7 +56,9 @@ public:
         startButton.setBounds(area.removeFromTop(30));
         area.removeFromTop(10);
         stopButton.setBounds(area.removeFromTop(30));
-        area.removeFromTop(10);
+        area.removeFromTop(5);
+        stressButton.setBounds(area.removeFromTop(25));
+        area.removeFromTop(5);
         statusLabel.setBounds(area);
     }
     
@@ -56,83 +67,62 @@ private:
     {
         if (midiOutput)
         {
-            patternIndex = 0;
-            startTimer(500); // Play note every 500ms
+            InjectionEngine::Settings settings; // A note every 500ms, as before
+
+            if (stressButton.getToggleState())
+            {
+                settings.mode = InjectionEngine::Mode::Stress;
+                settings.controllersPerSecond = 500.0;
+                settings.pitchBendsPerSecond = 500.0;
+                settings.aftertouchPerSecond = 200.0;
+            }
+
+            if (!engine.start(settings))
+            {
+                statusLabel.setText("Failed to start the injector thread", juce::dontSendNotification);
+                return;
+            }
+
+            startTimerHz(4); // Status display only - note timing lives on the engine thread
             startButton.setEnabled(false);
             stopButton.setEnabled(true);
-            statusLabel.setText("Playing C major scale patterns...", juce::dontSendNotification);
+            stressButton.setEnabled(false);
+            statusLabel.setText(getActivity(), juce::dontSendNotification);
         }
     }
     
     void stopInjection()
     {
+        // Stopping the engine releases any notes it still holds
+        engine.stop();
         stopTimer();
-        // Send all notes off
-        if (midiOutput)
-        {
-            for (int note = 0; note < 128; ++note)
-            {
-                midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, note, 0.0f));
-            }
-        }
         startButton.setEnabled(true);
         stopButton.setEnabled(false);
-        statusLabel.setText("Stopped", juce::dontSendNotification);
+        stressButton.setEnabled(true);
+        statusLabel.setText("Stopped\n" + getTimingSummary(), juce::dontSendNotification);
     }
     
     void timerCallback() override
     {
-        if (!midiOutput) return;
-        
-        // C major scale: C, D, E, F, G, A, B, C
-        static const int notes[] = {60, 62, 64, 65, 67, 69, 71, 72};
-        static const float velocities[] = {0.8f, 0.6f, 0.9f, 0.7f, 0.85f, 0.75f, 0.65f, 1.0f};
-        
-        int note = notes[patternIndex % 8];
-        float velocity = velocities[patternIndex % 8];
-        
-        // Send note on
-        midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, note, velocity));
-        
-        // Schedule note off after 400ms
-        juce::Timer::callAfterDelay(400, [this, note]()
-        {
-            if (midiOutput)
-                midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, note, 0.0f));
-        });
-        
-        patternIndex++;
-        
-        // Add chord every 4 notes
-        if (patternIndex % 4 == 0)
-        {
-            juce::Timer::callAfterDelay(100, [this]()
-            {
-                if (midiOutput)
-                {
-                    // C major triad
-                    midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, 60, 0.6f)); // C
-                    midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, 64, 0.6f)); // E
-                    midiOutput->sendMessageNow(juce::MidiMessage::noteOn(1, 67, 0.6f)); // G
-                    
-                    juce::Timer::callAfterDelay(300, [this]()
-                    {
-                        if (midiOutput)
-                        {
-                            midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, 60, 0.0f));
-                            midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, 64, 0.0f));
-                            midiOutput->sendMessageNow(juce::MidiMessage::noteOff(1, 67, 0.0f));
-                        }
-                    });
-                }
-            });
-        }
+        statusLabel.setText(getActivity() + "\n" + getTimingSummary(), juce::dontSendNotification);
+    }
+
+    juce::String getActivity() const
+    {
+        return stressButton.getToggleState() ? "Sending stress load..." : "Playing C major scale patterns...";
+    }
+
+    juce::String getTimingSummary() const
+    {
+        auto& histogram = engine.getHistogram();
+        return histogram.getSummary() + ", " + juce::String(histogram.getCountAtOrAbove(1.0)) + " late (>= 1ms)";
     }
     
     juce::TextButton startButton, stopButton;
+    juce::ToggleButton stressButton;
     juce::Label statusLabel;
     std::unique_ptr<juce::MidiOutput> midiOutput;
-    int patternIndex = 0;
+    InjectionEngine engine; // After the output so its thread stops before the device closes
 };
 
 class MidiInjectorApp : public juce::JUCEApplication
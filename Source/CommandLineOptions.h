@@ -0,0 +1,33 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+// Option values for the command-line tools. juce::ArgumentList only finds a
+// long option's value in the "--option=value" form; these also accept the
+// "--option value" form the Makefile and help texts use.
+struct CommandLineOptions
+{
+    // The option's value, or an empty string when it's missing or has none
+    static juce::String getValue(const juce::ArgumentList& args, const juce::String& option)
+    {
+        auto joined = args.getValueForOption(option);
+        if (joined.isNotEmpty())
+            return joined;
+
+        auto index = args.indexOfOption(option);
+        if (index < 0 || index + 1 >= args.size())
+            return {};
+
+        // The next argument, unless it's another option (a negative number still counts as a value)
+        auto next = args[index + 1];
+        if (next.isLongOption() || (next.isShortOption() && ! next.text.substring(1).containsOnly("0123456789.")))
+            return {};
+
+        return next.text;
+    }
+
+    static double getDouble(const juce::ArgumentList& args, const juce::String& option, double defaultValue)
+    {
+        auto value = getValue(args, option);
+        return value.isNotEmpty() ? value.getDoubleValue() : defaultValue;
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Standard MIDI File reading and writing shared by the injector and the
+// workstation's pattern export.
+//
+// Reading merges a type 0 or type 1 file into one timeline in seconds with the
+// file's tempo map applied, which is what a player schedules from. Type 2 files
+// hold independent sequences with no shared timeline and are rejected.
+//
+// Writing takes events timestamped in ticks. A type 1 file gets a conductor
+// track (tempo, time signature) followed by one track per event sequence;
+// type 0 puts everything in a single track.
+struct MidiFileIO
+{
+    static bool read(const juce::File& file, juce::MidiMessageSequence& sequence,
+                     int* fileType = nullptr, int* numTracks = nullptr)
+    {
+        juce::FileInputStream stream(file);
+        if (! stream.openedOk())
+            return false;
+
+        juce::MidiFile midiFile;
+        int type = 0;
+        if (! midiFile.readFrom(stream, true, &type) || type > 1)
+            return false;
+
+        midiFile.convertTimestampTicksToSeconds();
+
+        sequence.clear();
+        for (int track = 0; track < midiFile.getNumTracks(); ++track)
+            sequence.addSequence(*midiFile.getTrack(track), 0.0);
+
+        sequence.updateMatchedPairs();
+
+        if (fileType != nullptr)
+            *fileType = type;
+        if (numTracks != nullptr)
+            *numTracks = midiFile.getNumTracks();
+
+        return true;
+    }
+
+    using Track = std::pair<juce::String, juce::MidiMessageSequence>; // Name, events in ticks
+
+    // Type 1 writes each track after the conductor; type 0 merges them all into one
+    static bool write(const juce::File& file, const std::vector<Track>& tracks,
+                      double bpm, int ticksPerQuarterNote, int fileType = 1)
+    {
+        jassert(fileType == 0 || fileType == 1);
+
+        juce::MidiMessageSequence conductor;
+        conductor.addEvent(juce::MidiMessage::tempoMetaEvent(juce::roundToInt(60000000.0 / juce::jmax(1.0, bpm))), 0.0);
+        conductor.addEvent(juce::MidiMessage::timeSignatureMetaEvent(4, 4), 0.0);
+
+        juce::MidiFile midiFile;
+        midiFile.setTicksPerQuarterNote(ticksPerQuarterNote);
+
+        if (fileType != 0)
+            midiFile.addTrack(conductor);
+
+        for (auto& [name, events] : tracks)
+        {
+            juce::MidiMessageSequence track;
+            if (name.isNotEmpty() && fileType != 0)
+                track.addEvent(juce::MidiMessage::textMetaEvent(3, name), 0.0);
+            track.addSequence(events, 0.0);
+
+            if (fileType == 0)
+            {
+                conductor.addSequence(track, 0.0);
+            }
+            else
+            {
+                track.updateMatchedPairs();
+                midiFile.addTrack(track);
+            }
+        }
+
+        if (fileType == 0)
+        {
+            conductor.updateMatchedPairs();
+            midiFile.addTrack(conductor);
+        }
+
+        // Written next to the target and swapped in, so a failed write leaves the old file intact
+        juce::TemporaryFile temporary(file);
+        {
+            juce::FileOutputStream stream(temporary.getFile());
+            if (! stream.openedOk() || ! midiFile.writeTo(stream, fileType))
+                return false;
+
+            stream.flush();
+            if (stream.getStatus().failed())
+                return false;
+        }
+
+        return temporary.overwriteTargetFileWithTemporary();
+    }
+};
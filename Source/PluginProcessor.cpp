@@ -110,7 +110,7 @@ void SineSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
             voice->setADSRParameters({
                 *attackParam, *decayParam, *sustainParam, *releaseParam
             });
-            voice->prepareFilter(sampleRate);
+            voice->prepare(sampleRate, samplesPerBlock);
         }
     }
 }
@@ -0,0 +1,267 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "SineWaveSound.h"
+#include "VoicePolicies.h"
+
+// Header-only voice shared by every synth target. Each policy is a plain class
+// so the whole sample loop inlines into one function per specialisation; the
+// only virtual call is renderNextBlock itself, once per block.
+//
+// Setters forward to the policies and are only instantiated when a processor
+// calls them, so a policy only needs the methods its target actually uses.
+//
+// Per-note expression: pitch bend, pressure (channel or polyphonic) and timbre
+// (CC74) arrive per MIDI channel, which under MPE means per note. Each is
+// smoothed once per control period rather than per sample, and routed to the
+// oscillator frequency, the amplitude and the filter cutoff respectively. An MPE
+// zone's master-channel bend arrives separately and adds to every note's own.
+template <typename OscillatorPolicy, typename FilterPolicy, typename EnvelopePolicy, typename ModulationPolicy>
+class SynthVoice : public juce::SynthesiserVoice
+{
+public:
+    using Oscillator = OscillatorPolicy;
+    using Filter = FilterPolicy;
+    using Envelope = EnvelopePolicy;
+    using Modulation = ModulationPolicy;
+
+    bool canPlaySound(juce::SynthesiserSound* sound) override
+    {
+        return dynamic_cast<SineWaveSound*>(sound) != nullptr;
+    }
+
+    void startNote(int midiNoteNumber, float velocity,
+                   juce::SynthesiserSound*, int currentPitchWheelPosition) override
+    {
+        level = velocity * VELOCITY_SCALE;
+        oscillator.reset();
+        noteFrequency = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+
+        // A new note starts from its channel's bend and neutral pressure and timbre, without gliding
+        channelBend = wheelToSemitones(currentPitchWheelPosition);
+        pitchBend = targetPitchBend = channelBend + zoneBend;
+        pressure = targetPressure = 0.0f;
+        timbre = targetTimbre = 0.5f;
+        expressionGain = 1.0f;
+        expressionGainStep = 0.0f;
+        applyPitchBend();
+        applyTimbre();
+        samplesUntilControl = 0;
+
+        modulation.noteOn();
+        envelope.noteOn();
+    }
+
+    void stopNote(float /*velocity*/, bool allowTailOff) override
+    {
+        if (allowTailOff)
+        {
+            envelope.noteOff();
+        }
+        else
+        {
+            envelope.reset();
+            clearCurrentNote();
+        }
+    }
+
+    void pitchWheelMoved(int newPitchWheelValue) override
+    {
+        channelBend = wheelToSemitones(newPitchWheelValue);
+        targetPitchBend = channelBend + zoneBend;
+    }
+
+    // MPE master-channel bend, shared by the whole zone over a keyboard's range whatever the member range
+    void zonePitchWheelMoved(int newPitchWheelValue)
+    {
+        zoneBend = (float) (newPitchWheelValue - 8192) / 8192.0f * zoneBendRange;
+        targetPitchBend = channelBend + zoneBend;
+    }
+    void channelPressureChanged(int newValue) override { targetPressure = (float) newValue / 127.0f; }
+    void aftertouchChanged(int newValue) override { targetPressure = (float) newValue / 127.0f; }
+
+    void controllerMoved(int controllerNumber, int newValue) override
+    {
+        if (controllerNumber == timbreController)
+            targetTimbre = (float) newValue / 128.0f; // 64 is centred
+    }
+
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
+                         int startSample, int numSamples) override
+    {
+        if (! isVoiceActive())
+            return;
+
+        auto numChannels = outputBuffer.getNumChannels();
+        auto* const* channels = outputBuffer.getArrayOfWritePointers();
+        auto stereo = numChannels > 1 && isStereoStack();
+
+        for (auto end = startSample + numSamples; startSample < end; ++startSample)
+        {
+            if (--samplesUntilControl <= 0)
+                updateExpression();
+
+            expressionGain += expressionGainStep;
+
+            auto gain = level * expressionGain * envelope.getNextSample();
+
+            if constexpr (Modulation::isEnabled)
+                gain *= 1.0f + modulation.nextSample();
+
+            if (stereo)
+            {
+                renderStereoSample(channels, startSample, gain);
+            }
+            else
+            {
+                auto sample = filter.processSample(oscillator.nextSample() * gain);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channels[channel][startSample] += sample;
+            }
+
+            if (! envelope.isActive())
+            {
+                clearCurrentNote();
+                break;
+            }
+        }
+    }
+
+    void prepare(double sampleRate, int samplesPerBlock)
+    {
+        filter.prepare(sampleRate, samplesPerBlock);
+        setPlaybackRate(sampleRate);
+    }
+
+    // Moves the voice to a new rate (an oversampling change) without stopping or
+    // resetting a sounding note: juce::Synthesiser's own rate change stops every note
+    void setPlaybackRate(double sampleRate)
+    {
+        setCurrentPlaybackSampleRate(sampleRate);
+        filter.setSampleRate(sampleRate);
+        envelope.prepare(sampleRate);
+        modulation.prepare(sampleRate);
+
+        // One-pole glide reaching ~63% of a change within expressionSmoothingSeconds
+        expressionSmoothing = (float) (1.0 - std::exp(-controlInterval / (expressionSmoothingSeconds * sampleRate)));
+
+        if (isVoiceActive())
+            applyPitchBend();
+    }
+
+    void setADSRParameters(const juce::ADSR::Parameters& params) { envelope.setParameters(params); }
+
+    void setFilterParameters(float cutoff, float resonance)
+    {
+        filterCutoff = cutoff;
+        filterResonance = resonance;
+        applyTimbre();
+    }
+
+    // Bend range in semitones either side of centre: 2 for a plain keyboard, 48 for MPE member channels
+    void setPitchBendRange(float semitones) { pitchBendRange = semitones; }
+
+    void setFilterType(FilterType type) { filter.setFilterType(type); }
+    void setWaveformType(WaveformType type) { oscillator.setWaveformType(type); }
+    void setBandLimited(bool shouldBeBandLimited) { oscillator.setBandLimited(shouldBeBandLimited); }
+    void setLFOParameters(float rate, float depth, WaveformType shape) { modulation.setLFOParameters(rate, depth, shape); }
+    void setUnison(int numVoices, float detuneCents, float spread) { oscillator.setUnison(numVoices, detuneCents, spread); }
+
+private:
+    static constexpr float VELOCITY_SCALE = 0.15f;
+    static constexpr int controlInterval = 32;                 // Samples per expression update
+    static constexpr double expressionSmoothingSeconds = 0.005;
+    static constexpr int timbreController = 74;                // MPE "slide"
+    static constexpr float timbreRangeOctaves = 2.0f;          // Cutoff shift at full timbre, either way
+    static constexpr float zoneBendRange = 2.0f;               // MPE master-channel bend, semitones either way
+
+    Oscillator oscillator;
+    Filter filter;
+    Envelope envelope;
+    Modulation modulation;
+
+    float level = 0.0f;
+
+    // Expression: value and target per dimension, bend in semitones, pressure and timbre 0-1
+    double noteFrequency = 440.0;
+    float pitchBend = 0.0f, targetPitchBend = 0.0f;
+    float channelBend = 0.0f, zoneBend = 0.0f;                 // The target's two parts
+    float pressure = 0.0f, targetPressure = 0.0f;
+    float timbre = 0.5f, targetTimbre = 0.5f;
+    float pitchBendRange = 2.0f;
+    float expressionSmoothing = 1.0f;
+    float expressionGain = 1.0f, expressionGainStep = 0.0f;
+    float filterCutoff = 1000.0f, filterResonance = 0.7f;
+    int samplesUntilControl = 0;
+
+    bool isStereoStack() const noexcept
+    {
+        if constexpr (Oscillator::hasUnison)
+            return oscillator.isStereo();
+        else
+            return false;
+    }
+
+    // A unison stack, filtered per side
+    void renderStereoSample(float* const* channels, int sample, float gain) noexcept
+    {
+        if constexpr (Oscillator::hasUnison)
+        {
+            float left, right;
+            oscillator.nextStereoSample(left, right);
+            channels[0][sample] += filter.processSample(left * gain, 0);
+            channels[1][sample] += filter.processSample(right * gain, 1);
+        }
+        else
+        {
+            juce::ignoreUnused(channels, sample, gain);
+        }
+    }
+
+    float wheelToSemitones(int wheelValue) const noexcept
+    {
+        return (float) (wheelValue - 8192) / 8192.0f * pitchBendRange;
+    }
+
+    // Moves value towards target; false once it has arrived, so settled dimensions cost nothing
+    bool glide(float& value, float target) const noexcept
+    {
+        if (value == target)
+            return false;
+
+        value += (target - value) * expressionSmoothing;
+        if (std::abs(target - value) < 1.0e-4f)
+            value = target;
+
+        return true;
+    }
+
+    void applyPitchBend()
+    {
+        oscillator.setFrequency(noteFrequency * std::exp2(pitchBend / 12.0), getSampleRate());
+    }
+
+    void applyTimbre()
+    {
+        // Centred timbre leaves the cutoff where the controls put it
+        auto cutoff = timbre == 0.5f ? filterCutoff
+                                     : filterCutoff * std::exp2((timbre - 0.5f) * 2.0f * timbreRangeOctaves);
+        filter.setParameters(cutoff, filterResonance);
+    }
+
+    void updateExpression()
+    {
+        samplesUntilControl = controlInterval;
+
+        if (glide(pitchBend, targetPitchBend))
+            applyPitchBend();
+
+        if (glide(timbre, targetTimbre))
+            applyTimbre();
+
+        // Pressure adds up to +6dB, ramped across the period so it never steps
+        glide(pressure, targetPressure);
+        expressionGainStep = (1.0f + pressure - expressionGain) / (float) controlInterval;
+    }
+};
@@ -0,0 +1,571 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+enum class WaveformType
+{
+    Sine = 0,
+    Sawtooth,
+    Square,
+    Triangle
+};
+
+enum class FilterType
+{
+    Lowpass = 0,
+    Highpass,
+    Bandpass,
+    Notch
+};
+
+// Sample kernels shared by every voice. Phase is normalised to [0, 1) so the
+// oscillators never need a divide by 2*pi or a std::floor in the sample loop.
+namespace VoiceKernels
+{
+    struct SineTable
+    {
+        static constexpr int size = 2048;
+
+        SineTable()
+        {
+            for (int i = 0; i <= size; ++i)
+                table[(size_t) i] = (float) std::sin(juce::MathConstants<double>::twoPi * i / size);
+        }
+
+        static const SineTable& get()
+        {
+            static const SineTable instance;
+            return instance;
+        }
+
+        // Linear interpolation keeps the error around -118dB with a 2048 point table
+        float lookup(double phase) const noexcept
+        {
+            auto position = phase * size;
+            auto index = (int) position;
+            auto fraction = (float) (position - index);
+            return table[(size_t) index] + fraction * (table[(size_t) index + 1] - table[(size_t) index]);
+        }
+
+        std::array<float, size + 1> table;
+    };
+
+    inline float sawtooth(double phase) noexcept
+    {
+        return (float) (phase < 0.5 ? 2.0 * phase : 2.0 * phase - 2.0);
+    }
+
+    inline float square(double phase) noexcept
+    {
+        return phase < 0.5 ? 1.0f : -1.0f;
+    }
+
+    inline float triangle(double phase) noexcept
+    {
+        return (float) (phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase);
+    }
+
+    // PolyBLEP residual for a unit step at t = 0, with dt the phase increment per sample
+    inline double polyBlep(double t, double dt) noexcept
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0;
+        }
+
+        if (t > 1.0 - dt)
+        {
+            t = (t - 1.0) / dt;
+            return t * t + t + t + 1.0;
+        }
+
+        return 0.0;
+    }
+
+    // Band-limited variants: same phase alignment as the naive shapes, with the
+    // step discontinuities smoothed so they stop folding back below Nyquist
+    inline float bandLimitedSawtooth(double phase, double dt) noexcept
+    {
+        auto t = phase + 0.5 >= 1.0 ? phase - 0.5 : phase + 0.5;
+        return (float) (2.0 * t - 1.0 - polyBlep(t, dt));
+    }
+
+    inline float bandLimitedSquare(double phase, double dt) noexcept
+    {
+        auto falling = phase + 0.5 >= 1.0 ? phase - 0.5 : phase + 0.5;
+        return (float) ((phase < 0.5 ? 1.0 : -1.0) + polyBlep(phase, dt) - polyBlep(falling, dt));
+    }
+
+    inline float waveform(WaveformType type, const SineTable& sineTable, double phase) noexcept
+    {
+        switch (type)
+        {
+            case WaveformType::Sawtooth: return sawtooth(phase);
+            case WaveformType::Square:   return square(phase);
+            case WaveformType::Triangle: return triangle(phase);
+            case WaveformType::Sine:
+            default:                     return sineTable.lookup(phase);
+        }
+    }
+
+    inline double advancePhase(double phase, double increment) noexcept
+    {
+        phase += increment;
+        return phase >= 1.0 ? phase - 1.0 : phase;
+    }
+
+    // The same shapes a SIMD register of oscillators at a time, for unison. The
+    // branches become lane masks; inverseDt is 1 / dt, as registers can't divide.
+    namespace Batch
+    {
+        using Vector = juce::dsp::SIMDRegister<float>;
+
+        inline Vector wrap(Vector phase) noexcept
+        {
+            return phase - (Vector::expand(1.0f) & Vector::greaterThanOrEqual(phase, Vector::expand(1.0f)));
+        }
+
+        inline Vector polyBlep(Vector t, Vector dt, Vector inverseDt) noexcept
+        {
+            auto one = Vector::expand(1.0f);
+            auto start = t * inverseDt;
+            auto end = (t - one) * inverseDt;
+
+            return ((start + start - start * start - one) & Vector::lessThan(t, dt))
+                 + ((end * end + end + end + one) & Vector::greaterThan(t, one - dt));
+        }
+
+        inline Vector sawtooth(Vector phase) noexcept
+        {
+            return phase + phase - (Vector::expand(2.0f) & Vector::greaterThanOrEqual(phase, Vector::expand(0.5f)));
+        }
+
+        inline Vector square(Vector phase) noexcept
+        {
+            return Vector::expand(1.0f) - (Vector::expand(2.0f) & Vector::greaterThanOrEqual(phase, Vector::expand(0.5f)));
+        }
+
+        inline Vector triangle(Vector phase) noexcept
+        {
+            // 1 - 4|phase - 0.5|, which is the scalar triangle's two ramps
+            auto centred = phase - Vector::expand(0.5f);
+            auto magnitude = Vector::max(centred, Vector::expand(0.0f) - centred);
+            return Vector::expand(1.0f) - Vector::expand(4.0f) * magnitude;
+        }
+
+        inline Vector bandLimitedSawtooth(Vector phase, Vector dt, Vector inverseDt) noexcept
+        {
+            auto t = wrap(phase + Vector::expand(0.5f));
+            return t + t - Vector::expand(1.0f) - polyBlep(t, dt, inverseDt);
+        }
+
+        inline Vector bandLimitedSquare(Vector phase, Vector dt, Vector inverseDt) noexcept
+        {
+            auto falling = wrap(phase + Vector::expand(0.5f));
+            return square(phase) + polyBlep(phase, dt, inverseDt) - polyBlep(falling, dt, inverseDt);
+        }
+
+        // No gather, so the sine table is read a lane at a time
+        inline Vector sine(const SineTable& sineTable, Vector phase) noexcept
+        {
+            Vector result;
+            for (size_t lane = 0; lane < Vector::SIMDNumElements; ++lane)
+                result.set(lane, sineTable.lookup(phase.get(lane)));
+            return result;
+        }
+    }
+}
+
+//==============================================================================
+// Oscillator policies: reset(), setFrequency(hz, sampleRate), nextSample(), and
+// hasUnison when the policy can also produce a stereo stack (see UnisonOscillator)
+
+class SineOscillator
+{
+public:
+    static constexpr bool hasUnison = false;
+
+    void reset() noexcept { phase = 0.0; }
+    void setFrequency(double hz, double sampleRate) noexcept { increment = hz / sampleRate; }
+    void setWaveformType(WaveformType) noexcept {}
+
+    float nextSample() noexcept
+    {
+        auto sample = sineTable->lookup(phase);
+        phase = VoiceKernels::advancePhase(phase, increment);
+        return sample;
+    }
+
+private:
+    const VoiceKernels::SineTable* sineTable = &VoiceKernels::SineTable::get();
+    double phase = 0.0;
+    double increment = 0.0;
+};
+
+class MultiWaveOscillator
+{
+public:
+    static constexpr bool hasUnison = false;
+
+    void reset() noexcept { phase = 0.0; }
+    void setFrequency(double hz, double sampleRate) noexcept { increment = hz / sampleRate; }
+    void setWaveformType(WaveformType type) noexcept { waveformType = type; }
+
+    // PolyBLEP saw and square; sine and triangle are already cheap enough on aliasing
+    void setBandLimited(bool shouldBeBandLimited) noexcept { bandLimited = shouldBeBandLimited; }
+
+    float nextSample() noexcept
+    {
+        float sample;
+
+        if (bandLimited && waveformType == WaveformType::Sawtooth)
+            sample = VoiceKernels::bandLimitedSawtooth(phase, increment);
+        else if (bandLimited && waveformType == WaveformType::Square)
+            sample = VoiceKernels::bandLimitedSquare(phase, increment);
+        else
+            sample = VoiceKernels::waveform(waveformType, *sineTable, phase);
+
+        phase = VoiceKernels::advancePhase(phase, increment);
+        return sample;
+    }
+
+private:
+    const VoiceKernels::SineTable* sineTable = &VoiceKernels::SineTable::get();
+    WaveformType waveformType = WaveformType::Sine;
+    bool bandLimited = false;
+    double phase = 0.0;
+    double increment = 0.0;
+};
+
+// Unison stack: 1-16 detuned copies of the MultiWaveOscillator shapes, spread
+// across the stereo field. The copies are lanes of SIMD registers, so a sample
+// of the whole stack is a few vector operations plus a horizontal sum per side.
+// Stacked copies always use the PolyBLEP shapes, as their aliasing adds up.
+//
+// Besides the mono oscillator interface it offers nextStereoSample(), which
+// the voice uses (with a stereo filter) whenever more than one copy sounds.
+class UnisonOscillator
+{
+public:
+    using Vector = VoiceKernels::Batch::Vector;
+    static constexpr bool hasUnison = true;
+    static constexpr int maxVoices = 16;
+    static constexpr int numRegisters = (maxVoices + (int) Vector::SIMDNumElements - 1) / (int) Vector::SIMDNumElements;
+
+    UnisonOscillator() { updateStack(); }
+
+    void reset() noexcept
+    {
+        // Copies start at scattered phases so a stack doesn't open with one loud in-phase spike
+        for (int i = 0; i < maxVoices; ++i)
+            setLane(phases, i, i == 0 ? 0.0f : std::fmod(0.618034f * (float) i, 1.0f));
+    }
+
+    void setFrequency(double hz, double sampleRate) noexcept
+    {
+        baseIncrement = (float) (hz / sampleRate);
+        updateIncrements();
+    }
+
+    void setWaveformType(WaveformType type) noexcept { waveformType = type; }
+    void setBandLimited(bool shouldBeBandLimited) noexcept { bandLimited = shouldBeBandLimited; }
+
+    // Copies, total detune between the outermost two in cents, and stereo width 0-1
+    void setUnison(int numVoices, float detuneCents, float spread) noexcept
+    {
+        numVoices = juce::jlimit(1, maxVoices, numVoices);
+        if (numVoices != activeVoices || detuneCents != detune || spread != width)
+        {
+            activeVoices = numVoices;
+            detune = detuneCents;
+            width = spread;
+            updateStack();
+        }
+    }
+
+    bool isStereo() const noexcept { return activeVoices > 1; }
+
+    // Both sides folded down, scaled so a spread stack is as loud in mono as in stereo
+    float nextSample() noexcept
+    {
+        Vector left, right;
+        render(left, right);
+        return (left.sum() + right.sum()) * monoGain;
+    }
+
+    void nextStereoSample(float& left, float& right) noexcept
+    {
+        Vector leftSum, rightSum;
+        render(leftSum, rightSum);
+        left = leftSum.sum();
+        right = rightSum.sum();
+    }
+
+private:
+    const VoiceKernels::SineTable* sineTable = &VoiceKernels::SineTable::get();
+    WaveformType waveformType = WaveformType::Sine;
+    bool bandLimited = false;
+    int activeVoices = 1, numActiveRegisters = 1;
+    float detune = 0.0f, width = 0.0f;
+    float baseIncrement = 0.0f;
+    float monoGain = 0.5f;
+
+    std::array<Vector, numRegisters> phases {}, increments {}, inverseIncrements {};
+    std::array<Vector, numRegisters> ratios {}, leftGains {}, rightGains {};
+
+    static void setLane(std::array<Vector, numRegisters>& registers, int index, float value) noexcept
+    {
+        registers[(size_t) index / Vector::SIMDNumElements].set((size_t) index % Vector::SIMDNumElements, value);
+    }
+
+    // Detune ratios and pan gains; unused lanes get zero gain (and a sane ratio)
+    void updateStack() noexcept
+    {
+        numActiveRegisters = (activeVoices + (int) Vector::SIMDNumElements - 1) / (int) Vector::SIMDNumElements;
+        auto normalise = 1.0f / std::sqrt((float) activeVoices);
+        auto stereoPower = 0.0f, monoPower = 0.0f;
+
+        for (int i = 0; i < maxVoices; ++i)
+        {
+            auto position = activeVoices > 1 ? 2.0f * (float) i / (float) (activeVoices - 1) - 1.0f : 0.0f; // -1 to 1
+            auto active = i < activeVoices;
+
+            setLane(ratios, i, active ? std::exp2(position * detune * 0.5f / 1200.0f) : 1.0f);
+
+            // Equal-power pan; a single copy stays dead centre at full level, like the plain oscillator
+            auto angle = (position * width + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+            auto gain = active ? normalise : 0.0f;
+            auto leftGain = activeVoices > 1 ? gain * std::cos(angle) * juce::MathConstants<float>::sqrt2 : gain;
+            auto rightGain = activeVoices > 1 ? gain * std::sin(angle) * juce::MathConstants<float>::sqrt2 : gain;
+            setLane(leftGains, i, leftGain);
+            setLane(rightGains, i, rightGain);
+
+            // Detuned copies are uncorrelated, so their powers add
+            stereoPower += 0.5f * (leftGain * leftGain + rightGain * rightGain);
+            monoPower += 0.25f * (leftGain + rightGain) * (leftGain + rightGain);
+        }
+
+        // A panned copy folds down 3dB quieter; this gives the stack its stereo power back
+        monoGain = 0.5f * (monoPower > 0.0f ? std::sqrt(stereoPower / monoPower) : 1.0f);
+
+        updateIncrements();
+    }
+
+    void updateIncrements() noexcept
+    {
+        for (int r = 0; r < numActiveRegisters; ++r)
+        {
+            increments[(size_t) r] = ratios[(size_t) r] * Vector::expand(baseIncrement);
+
+            for (size_t lane = 0; lane < Vector::SIMDNumElements; ++lane)
+                inverseIncrements[(size_t) r].set(lane, 1.0f / juce::jmax(1.0e-9f, increments[(size_t) r].get(lane)));
+        }
+    }
+
+    void render(Vector& left, Vector& right) noexcept
+    {
+        using namespace VoiceKernels::Batch;
+        auto blep = bandLimited || activeVoices > 1;
+
+        left = Vector::expand(0.0f);
+        right = Vector::expand(0.0f);
+
+        for (int r = 0; r < numActiveRegisters; ++r)
+        {
+            auto phase = phases[(size_t) r];
+            auto dt = increments[(size_t) r];
+            Vector sample;
+
+            switch (waveformType)
+            {
+                case WaveformType::Sawtooth:
+                    sample = blep ? bandLimitedSawtooth(phase, dt, inverseIncrements[(size_t) r]) : sawtooth(phase);
+                    break;
+                case WaveformType::Square:
+                    sample = blep ? bandLimitedSquare(phase, dt, inverseIncrements[(size_t) r]) : square(phase);
+                    break;
+                case WaveformType::Triangle:
+                    sample = triangle(phase);
+                    break;
+                case WaveformType::Sine:
+                default:
+                    sample = VoiceKernels::Batch::sine(*sineTable, phase);
+                    break;
+            }
+
+            left += sample * leftGains[(size_t) r];
+            right += sample * rightGains[(size_t) r];
+            phases[(size_t) r] = wrap(phase + dt);
+        }
+    }
+};
+
+//==============================================================================
+// Filter policies: prepare(sampleRate, blockSize), setSampleRate(), reset(),
+// setParameters(), processSample()
+
+// Topology-preserving SVF, the same structure as juce::dsp::StateVariableTPTFilter.
+// It's written out here because the integrator states mean the same thing at
+// any rate, so setSampleRate() can move a sounding voice to a new rate (an
+// oversampling change) without clearing them the way juce's prepare() does.
+class StateVariableFilter
+{
+public:
+    void prepare(double sampleRate, int /*maximumBlockSize*/)
+    {
+        reset();
+        setSampleRate(sampleRate);
+    }
+
+    void setSampleRate(double sampleRate)
+    {
+        currentSampleRate = sampleRate;
+        updateFilter();
+    }
+
+    void reset() noexcept
+    {
+        s1.fill(0.0f);
+        s2.fill(0.0f); // Channel 1 only runs for a stereo (unison) voice
+    }
+
+    void setParameters(float cutoff, float resonance)
+    {
+        // Validate and clamp cutoff frequency (20Hz - 20kHz) and resonance (0.1 - 10.0)
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoff);
+        resonance = juce::jlimit(0.1f, 10.0f, resonance);
+
+        // Coefficient updates cost a tan(), so only recalculate when something moved
+        if (cutoff != filterCutoff || resonance != filterResonance)
+        {
+            filterCutoff = cutoff;
+            filterResonance = resonance;
+            updateFilter();
+        }
+    }
+
+    void setFilterType(FilterType type) { filterType = type; }
+
+    float processSample(float sample, int channel = 0) noexcept
+    {
+        auto& state1 = s1[(size_t) channel];
+        auto& state2 = s2[(size_t) channel];
+
+        auto highpass = h * (sample - state1 * (g + R2) - state2);
+        auto bandpass = highpass * g + state1;
+        state1 = highpass * g + bandpass;
+        auto lowpass = bandpass * g + state2;
+        state2 = bandpass * g + lowpass;
+
+        switch (filterType)
+        {
+            case FilterType::Highpass: return highpass;
+            case FilterType::Bandpass: return bandpass;
+            // LP + HP == input - bandpass / resonance
+            case FilterType::Notch:    return sample - bandpass / filterResonance;
+            case FilterType::Lowpass:
+            default:                   return lowpass;
+        }
+    }
+
+private:
+    FilterType filterType = FilterType::Lowpass;
+    double currentSampleRate = 44100.0;
+    float filterCutoff = 1000.0f;
+    float filterResonance = 0.7f;
+    float g = 0.0f, h = 0.0f, R2 = 0.0f;
+    std::array<float, 2> s1 {}, s2 {};
+
+    void updateFilter()
+    {
+        // Above Nyquist the warped cutoff blows up, so keep it just below
+        auto cutoff = juce::jmin((double) filterCutoff, currentSampleRate * 0.49);
+        g = (float) std::tan(juce::MathConstants<double>::pi * cutoff / currentSampleRate);
+        R2 = 1.0f / filterResonance;
+        h = 1.0f / (1.0f + R2 * g + g * g);
+    }
+};
+
+//==============================================================================
+// Envelope policies: prepare(sampleRate), noteOn(), noteOff(), reset(), getNextSample(), isActive()
+
+class ADSREnvelope
+{
+public:
+    // Keeps the current stage and level, so a sounding note carries on at the new rate
+    void prepare(double sampleRate)
+    {
+        adsr.setSampleRate(sampleRate);
+        adsr.setParameters(adsr.getParameters()); // Recalculates the per-sample rates
+    }
+    void setParameters(const juce::ADSR::Parameters& params) { adsr.setParameters(params); }
+
+    void noteOn() noexcept { adsr.noteOn(); }
+    void noteOff() noexcept { adsr.noteOff(); }
+    void reset() noexcept { adsr.reset(); }
+
+    float getNextSample() noexcept { return adsr.getNextSample(); }
+    bool isActive() const noexcept { return adsr.isActive(); }
+
+private:
+    juce::ADSR adsr;
+};
+
+//==============================================================================
+// Modulation policies: prepare(sampleRate), noteOn(), nextSample() returning an
+// amplitude offset. isEnabled lets the voice drop the multiply at compile time.
+
+class NoModulation
+{
+public:
+    static constexpr bool isEnabled = false;
+
+    void prepare(double) noexcept {}
+    void noteOn() noexcept {}
+    void setLFOParameters(float, float, WaveformType) noexcept {}
+    float nextSample() noexcept { return 0.0f; }
+};
+
+class LFOModulation
+{
+public:
+    static constexpr bool isEnabled = true;
+
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        increment = lfoRate / sampleRate;
+    }
+
+    void noteOn() noexcept { phase = 0.0; }
+
+    void setLFOParameters(float rate, float depth, WaveformType shape) noexcept
+    {
+        lfoRate = rate;
+        lfoDepth = depth;
+        lfoWaveform = shape;
+        increment = lfoRate / sampleRate;
+    }
+
+    float nextSample() noexcept
+    {
+        if (lfoDepth == 0.0f)
+            return 0.0f;
+
+        auto sample = VoiceKernels::waveform(lfoWaveform, *sineTable, phase);
+        phase = VoiceKernels::advancePhase(phase, increment);
+        return sample * lfoDepth;
+    }
+
+private:
+    const VoiceKernels::SineTable* sineTable = &VoiceKernels::SineTable::get();
+    double sampleRate = 44100.0;
+    double phase = 0.0;
+    double increment = 0.0;
+
+    float lfoRate = 2.0f; // Hz
+    float lfoDepth = 0.0f; // 0.0 to 1.0
+    WaveformType lfoWaveform = WaveformType::Sine;
+};